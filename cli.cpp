@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "Bench.h"
+#include "Epd.h"
+#include "Match.h"
+#include "PerfCounters.h"
+#include "Perft.h"
+#include "Trace.h"
+#include "Tuner.h"
+#include "Uci.h"
+
+static const int DEFAULT_EPD_MOVE_TIME = 1000;   // Milliseconds
+static const int DEFAULT_MATCH_TIME = 10000;     // Milliseconds per game
+static const int DEFAULT_MATCH_INCREMENT = 100;  // Milliseconds per move
+static const int DEFAULT_TUNE_ITERATIONS = 1000;
+static const double DEFAULT_TUNE_RATE = 1.0;     // Centipawns per step
+
+// chess-cli bench [depth <plies>] [trace <file>]
+// Node count is the signature of the search, it must not change with optimizations which keep the searched tree
+// Trace of the hot path is written in the Chrome trace_event format, it requires a build with ENGINE_TRACE
+// Hardware counters per node are printed where perf_event_open is permitted
+static int runBench( int argc, char *argv[] ) {
+    int depth = BENCH_DEPTH;
+    std::string trace;
+    for ( int i = 2; i + 1 < argc; i += 2 ) {
+        const std::string option = argv[i];
+        if ( option == "depth" ) {
+            depth = std::stoi( argv[i + 1] );
+        } else if ( option == "trace" ) {
+            trace = argv[i + 1];
+        }
+    }
+    if ( !trace.empty() && !Trace::isEnabled() ) {
+        std::cerr << "Tracing is disabled, build with -DENGINE_TRACE=ON" << std::endl;
+        return 1;
+    }
+
+    PerfCounters counters;
+    counters.start();
+    const BenchReport report =
+        Bench::run( depth, []( const BenchResult &result ) { Bench::printResult( result, std::cerr ); } );
+    const PerfReading reading = counters.stop();
+    Bench::printReport( report, std::cout );
+    PerfCounters::printReport( reading, report.nodes, std::cout );
+
+    if ( !trace.empty() ) {
+        std::ofstream file( trace );
+        if ( !file ) {
+            std::cerr << "Cannot open " << trace << std::endl;
+            return 1;
+        }
+        Trace::write( file );
+    }
+    return 0;
+}
+
+// chess-cli perft [json <file>] [baseline <file>] [threshold <percent>]
+// Fails if any node count is wrong or if any position is slower than its baseline by more than the threshold
+static int runPerft( int argc, char *argv[] ) {
+    std::string json, baselinePath;
+    double threshold = PERFT_REGRESSION_THRESHOLD;
+    for ( int i = 2; i + 1 < argc; i += 2 ) {
+        const std::string option = argv[i];
+        if ( option == "json" ) {
+            json = argv[i + 1];
+        } else if ( option == "baseline" ) {
+            baselinePath = argv[i + 1];
+        } else if ( option == "threshold" ) {
+            threshold = std::stod( argv[i + 1] );
+        }
+    }
+
+    PerfCounters counters;
+    counters.start();
+    const PerftReport report = Perft::run();
+    const PerfReading reading = counters.stop();
+    Perft::printReport( report, std::cout );
+    PerfCounters::printReport( reading, report.nodes, std::cout );
+    if ( !json.empty() ) {
+        std::ofstream file( json );
+        if ( !file ) {
+            std::cerr << "Cannot open " << json << std::endl;
+            return 1;
+        }
+        Perft::writeJson( report, file );
+    }
+
+    int status = report.failed > 0 ? 1 : 0;
+    if ( !baselinePath.empty() ) {
+        std::ifstream file( baselinePath );
+        if ( !file ) {
+            std::cerr << "Cannot open " << baselinePath << std::endl;
+            return 1;
+        }
+        try {
+            for ( const auto &regression : Perft::compare( report, Perft::readBaseline( file ), threshold ) ) {
+                std::cout << "Regression " << regression.name << ": " << regression.nps << " nps, baseline "
+                          << regression.baselineNps << " nps (" << std::fixed << std::setprecision( 1 )
+                          << regression.change << "%)" << std::defaultfloat << std::endl;
+                status = 1;
+            }
+        } catch ( const std::exception &e ) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return status;
+}
+
+// chess-cli epd <file> [movetime <ms>] [depth <plies>] [nodes <count>] [threads <count>]
+static int runEpd( int argc, char *argv[] ) {
+    if ( argc < 3 ) {
+        std::cerr << "Usage: chess-cli epd <file> [movetime <ms>] [depth <plies>] [nodes <count>] [threads <count>]"
+                  << std::endl;
+        return 1;
+    }
+
+    SearchLimits limits;
+    int threads = std::max( 1u, std::thread::hardware_concurrency() );
+    for ( int i = 3; i + 1 < argc; i += 2 ) {
+        const std::string option = argv[i];
+        const int value = std::stoi( argv[i + 1] );
+        if ( option == "movetime" ) {
+            limits.moveTime = value;
+        } else if ( option == "depth" ) {
+            limits.depth = value;
+        } else if ( option == "nodes" ) {
+            limits.nodes = value;
+        } else if ( option == "threads" ) {
+            threads = value;
+        }
+    }
+    if ( limits.moveTime == 0 && limits.depth == MAX_SEARCH_DEPTH && limits.nodes == 0 ) {
+        limits.moveTime = DEFAULT_EPD_MOVE_TIME;
+    }
+
+    std::ifstream file( argv[2] );
+    if ( !file ) {
+        std::cerr << "Cannot open " << argv[2] << std::endl;
+        return 1;
+    }
+    try {
+        const EpdSuite suite( file );
+        EpdSuite::printReport( suite.run( limits, threads ), std::cout );
+    } catch ( const std::exception &e ) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// chess-cli match <openings> [games <count>] [concurrency <count>] [time <ms>] [inc <ms>] [nodes <count>]
+//                 [depth1 <plies>] [depth2 <plies>] [nodes1 <count>] [nodes2 <count>] [threads1 <count>]
+//                 [threads2 <count>] [elo0 <elo>] [elo1 <elo>]
+// Players differ only by their own limits, SPRT runs if elo0 or elo1 is given
+static int runMatch( int argc, char *argv[] ) {
+    if ( argc < 3 ) {
+        std::cerr << "Usage: chess-cli match <openings> [games <count>] [concurrency <count>] [time <ms>] [inc <ms>] "
+                     "[nodes <count>] [depth1 <plies>] [depth2 <plies>] [nodes1 <count>] [nodes2 <count>] "
+                     "[threads1 <count>] [threads2 <count>] [elo0 <elo>] [elo1 <elo>]"
+                  << std::endl;
+        return 1;
+    }
+
+    MatchPlayer first, second;
+    first.name = "first";
+    second.name = "second";
+    MatchOptions options;
+    options.concurrency = std::max( 1u, std::thread::hardware_concurrency() );
+    options.time = -1;
+    for ( int i = 3; i + 1 < argc; i += 2 ) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if ( option == "games" ) {
+            options.games = std::stoi( value );
+        } else if ( option == "concurrency" ) {
+            options.concurrency = std::stoi( value );
+        } else if ( option == "time" ) {
+            options.time = std::stoi( value );
+        } else if ( option == "inc" ) {
+            options.increment = std::stoi( value );
+        } else if ( option == "nodes" ) {
+            options.nodes = std::stoull( value );
+        } else if ( option == "depth1" || option == "depth2" ) {
+            ( option == "depth1" ? first : second ).limits.depth = std::stoi( value );
+        } else if ( option == "nodes1" || option == "nodes2" ) {
+            ( option == "nodes1" ? first : second ).limits.nodes = std::stoull( value );
+        } else if ( option == "threads1" || option == "threads2" ) {
+            ( option == "threads1" ? first : second ).threads = std::stoi( value );
+        } else if ( option == "elo0" || option == "elo1" ) {
+            ( option == "elo0" ? options.elo0 : options.elo1 ) = std::stod( value );
+            options.sprt = true;
+        }
+    }
+    // Clock is used unless the game is controlled by nodes only
+    if ( options.time < 0 ) {
+        options.time = options.nodes > 0 ? 0 : DEFAULT_MATCH_TIME;
+        options.increment = options.nodes > 0 ? options.increment : DEFAULT_MATCH_INCREMENT;
+    }
+
+    std::ifstream file( argv[2] );
+    if ( !file ) {
+        std::cerr << "Cannot open " << argv[2] << std::endl;
+        return 1;
+    }
+    try {
+        const EpdSuite suite( file );
+        std::vector<std::string> openings;
+        for ( const auto &position : suite.positions() ) {
+            openings.push_back( position.fen );
+        }
+        const Match match( first, second, openings, options );
+        const MatchReport report =
+            match.run( []( const MatchReport &progress ) { Match::printReport( progress, std::cout ); } );
+        std::cout << "Final: ";
+        Match::printReport( report, std::cout );
+    } catch ( const std::exception &e ) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// chess-cli tune <positions> [iterations <count>] [rate <centipawns>] [threads <count>] [output <file>]
+// Positions are packed records with game results, the tuned EvaluationParameters.h is written to the output
+static int runTune( int argc, char *argv[] ) {
+    if ( argc < 3 ) {
+        std::cerr << "Usage: chess-cli tune <positions> [iterations <count>] [rate <centipawns>] [threads <count>] "
+                     "[output <file>]"
+                  << std::endl;
+        return 1;
+    }
+
+    int iterations = DEFAULT_TUNE_ITERATIONS;
+    double rate = DEFAULT_TUNE_RATE;
+    int threads = std::max( 1u, std::thread::hardware_concurrency() );
+    std::string output;
+    for ( int i = 3; i + 1 < argc; i += 2 ) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if ( option == "iterations" ) {
+            iterations = std::stoi( value );
+        } else if ( option == "rate" ) {
+            rate = std::stod( value );
+        } else if ( option == "threads" ) {
+            threads = std::stoi( value );
+        } else if ( option == "output" ) {
+            output = value;
+        }
+    }
+
+    try {
+        Tuner tuner( threads );
+        tuner.addPositions( PositionFile( argv[2] ) );
+        const double scale = tuner.findScale();
+        std::cerr << "Positions " << tuner.size() << ", scale " << scale << std::endl;
+        tuner.tune( iterations, scale, rate, [&]( int iteration, double loss ) {
+            if ( iteration % 100 == 0 || iteration == 1 ) {
+                std::cerr << "Iteration " << iteration << ", loss " << loss << std::endl;
+            }
+        } );
+        std::cerr << "Final loss " << tuner.loss( scale ) << std::endl;
+
+        if ( output.empty() ) {
+            tuner.writeParameters( std::cout );
+        } else {
+            std::ofstream file( output );
+            if ( !file ) {
+                std::cerr << "Cannot open " << output << std::endl;
+                return 1;
+            }
+            tuner.writeParameters( file );
+        }
+    } catch ( const std::exception &e ) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Headless engine speaking the UCI protocol on the standard input and output
+int main( int argc, char *argv[] ) {
+    if ( argc > 1 && std::string( argv[1] ) == "bench" ) {
+        return runBench( argc, argv );
+    }
+    if ( argc > 1 && std::string( argv[1] ) == "perft" ) {
+        return runPerft( argc, argv );
+    }
+    if ( argc > 1 && std::string( argv[1] ) == "epd" ) {
+        return runEpd( argc, argv );
+    }
+    if ( argc > 1 && std::string( argv[1] ) == "match" ) {
+        return runMatch( argc, argv );
+    }
+    if ( argc > 1 && std::string( argv[1] ) == "tune" ) {
+        return runTune( argc, argv );
+    }
+
+    Uci uci( std::cin, std::cout );
+    uci.loop();
+    return 0;
+}
@@ -0,0 +1,45 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MoveContent.h"
+
+static const int BENCH_DEPTH = 4;
+
+struct BenchResult {
+    std::string fen;
+    MoveContent move;
+    uint64_t nodes;
+    int64_t time;  // Milliseconds
+};
+
+struct BenchReport {
+    std::vector<BenchResult> results;  // In the order of the positions
+    uint64_t nodes;                    // Signature of the search, changes with any change of the searched tree
+    int64_t time;                      // Milliseconds
+    uint64_t nps;
+};
+
+using BenchCallback = std::function<void( const BenchResult& )>;
+
+/**
+ * Fixed set of openings, middle games and endgames searched to a fixed depth by a single thread.
+ * Search without time limits is deterministic, so the total node count identifies the search algorithm:
+ * it has to stay the same for pure speed optimizations, while the nodes per second measure their effect.
+ */
+class Bench {
+public:
+    static const std::vector<std::string>& positions();
+
+    // Positions are searched one after another, onPosition is called after each of them
+    static BenchReport run( int depth = BENCH_DEPTH, const BenchCallback& onPosition = nullptr );
+    static void printResult( const BenchResult& result, std::ostream& out );
+    static void printReport( const BenchReport& report, std::ostream& out );
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef BITBASE_H
+#define BITBASE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+
+// Endings covered by the bitbases - a single piece against a bare king
+enum BitbaseEnding { KPK, KRK, KQK };
+
+/**
+ * Win/draw bitbases generated by retrograde analysis on the first use.
+ * Every position is stored as a single bit (win for the side with the piece or not),
+ * indexed by side to move, king squares and the piece square.
+ * Positions are normalized so that the side with the piece is white, then mirrored so that
+ * the pawn stands on files a-d (KPK) or the white king in the a1-d1-d4 triangle (KRK, KQK).
+ */
+class Bitbase {
+public:
+    static Bitbase &getInstance() {
+        static Bitbase instance;
+        return instance;
+    }
+
+    // Returns false if the position is not covered by the bitbases, otherwise sets win for the side with the piece
+    static bool probe( const Board &board, bool &win );
+
+    bool isWin( BitbaseEnding ending, PieceColor sideToMove, SquareIndex whiteKing, SquareIndex blackKing,
+                SquareIndex piece ) const;
+
+private:
+    Bitbase();
+    Bitbase( Bitbase &other ) = delete;
+
+    enum Result : uint8_t { UNKNOWN, INVALID, DRAW, WIN };
+
+    std::vector<uint64_t> wins_[3];  // Indexed by BitbaseEnding
+
+    static std::size_t size( BitbaseEnding ending );
+    static std::size_t index( BitbaseEnding ending, PieceColor sideToMove, SquareIndex whiteKing, SquareIndex blackKing,
+                              SquareIndex piece );
+    static Bitboard attacks( PieceType type, SquareIndex square, Bitboard occupied );
+
+    void generate( BitbaseEnding ending );
+    Result classify( BitbaseEnding ending, const std::vector<Result> &results, PieceColor sideToMove,
+                     SquareIndex whiteKing, SquareIndex blackKing, SquareIndex piece ) const;
+};
+
+#endif
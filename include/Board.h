@@ -3,16 +3,36 @@
 
 #include <array>
 #include <optional>
+#include <string>
+#include <string_view>
 
 #include "Common.h"
 #include "MoveContent.h"
+#include "PackedPosition.h"
 #include "Piece.h"
 
+static const int FEN_BUFFER_SIZE = 128;  // Enough for any position written by Board::toFEN, with the null
+
+// Result of Board::parseFEN, names the first invalid field
+enum FenError {
+    FEN_OK,
+    FEN_INVALID_PIECE_PLACEMENT,
+    FEN_INVALID_SIDE_TO_MOVE,
+    FEN_INVALID_CASTLING_RIGHTS,
+    FEN_INVALID_EN_PASSANT,
+    FEN_INVALID_HALF_MOVE_CLOCK,
+    FEN_INVALID_FULL_MOVE_NUMBER,
+};
+
+const char *fenErrorMessage( FenError error );
+
 class Board {
 public:
     // constructors
     Board();
-    Board( std::string FENString );
+    Board( std::string_view fen );
+    // Unpacks a record created by pack, throws std::invalid_argument on an invalid piece code
+    explicit Board( const PackedPosition &position );
     Board fastCopy() const;
 
     // members
@@ -23,7 +43,10 @@ public:
     bool whiteIsCheckMated;
     bool blackIsCheckMated;
     bool staleMate;
-    int score;
+    std::array<int, 2> score;                // Middle game and end game score, updated by makeMove
+    uint64_t materialKey;                    // Piece counts packed by MaterialTable, updated by makeMove
+    uint64_t pawnKey;                        // Zobrist key of the pawn structure, updated by makeMove
+    std::array<SquareIndex, 2> kingSquares;  // Indexed by PieceColor, updated by makeMove
     PieceColor sideToMove;
     MoveContent lastMove;
     SquareIndex enPassantSquare;
@@ -31,21 +54,42 @@ public:
 
     // methods
     void makeMove( SquareIndex src, SquareIndex dest, PieceType promotion = EMPTY );
+    // Same for a side to move known at compile time, Us has to be sideToMove (asserted in debug builds)
+    template <PieceColor Us>
+    void makeMove( SquareIndex src, SquareIndex dest, PieceType promotion = EMPTY );
     void makeMove( std::string move );  // d2d4 notation (d7d8Q for promotion)
-    // TODO: serializes Board object to FEN string notation
+    // Sets up the position without throwing or allocating, board is left in an unspecified state on error
+    FenError parseFEN( std::string_view fen );
+    // Writes the null terminated FEN into a buffer of FEN_BUFFER_SIZE chars, returns a pointer to the null
+    char *toFEN( char *out ) const;
     std::string toFEN() const;
+    // Score and result are only stored in the record, throws std::invalid_argument on more than 32 pieces
+    PackedPosition pack( int score = PackedPosition::NO_SCORE, int result = PackedPosition::NO_RESULT ) const;
+    // Plies since the last capture or pawn move, the fifty-move rule draws the game at 100
+    int halfMoveClock() const { return fiftyMoveCounter_; }
 
 private:
     int fiftyMoveCounter_;
+    int fullMoveNumber_;
     int threefoldRepetitionCounter_;
 
     // Helper methods
+    bool hasCastlingRight( int right ) const;
+    void setCastlingRights( const bool rights[4] );
+    void computeIncrementalState();
     bool enPassantIsAvailable() const;
     void validateMove( SquareIndex src, SquareIndex dest, PieceType promotion ) const;
-    void recordEnPassant( SquareIndex src, SquareIndex dest );
+    template <PieceColor Us>
+    void recordEnPassant( SquareIndex dest );
+    template <PieceColor Us>
     void handleEnPassant();
+    template <PieceColor Us>
     void handleCastling( SquareIndex src, SquareIndex dest );
     void handlePromotion( SquareIndex src, PieceType promotion );
+
+    // Incremental evaluation helpers
+    void addPieceScore( PieceColor color, PieceType type, SquareIndex square );
+    void removePieceScore( PieceColor color, PieceType type, SquareIndex square );
 };
 
 #endif
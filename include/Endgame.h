@@ -0,0 +1,25 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include "Board.h"
+
+/**
+ * Specialized evaluation functions for endgames the general evaluation plays badly.
+ * All functions return score positive for white, strongSide is the side with the extra material.
+ */
+class Endgame {
+public:
+    Endgame() = delete;
+
+    // King and rook or queen against king - drive the king to the edge
+    static int evaluateKXK( const Board &board, PieceColor strongSide );
+    // King, bishop and knight against king - drive the king to the corner of the bishop's color
+    static int evaluateKBNK( const Board &board, PieceColor strongSide );
+    // King and pawn against king - exact result from the KPK bitbase
+    static int evaluateKPK( const Board &board, PieceColor strongSide );
+
+    static int distance( SquareIndex a, SquareIndex b );
+    static int distanceToEdge( SquareIndex square );
+};
+
+#endif
@@ -1,11 +1,57 @@
 #ifndef ENGINE_H
 #define ENGINE_H
 
+#include <atomic>
+#include <future>
+#include <memory>
+#include <optional>
 #include <stack>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "Board.h"
 #include "MoveContent.h"
 #include "Movegen.h"
+#include "Polyglot.h"
+#include "Search.h"
+
+/**
+ * Search running on its own thread, returned by Engine::startSearch.
+ * Search works on a copy of the position, so the engine can be used and other searches started meanwhile.
+ * Destroying the handle stops the search and waits for it to finish.
+ */
+class SearchHandle {
+public:
+    SearchHandle( const Board& board, int threads, const SearchLimits& limits, SearchCallback onInfo,
+                  bool ponder = false );
+    SearchHandle( const MoveContent& bookMove );
+    ~SearchHandle();
+    SearchHandle( SearchHandle& ) = delete;
+    SearchHandle( SearchHandle&& ) = default;
+    SearchHandle& operator=( SearchHandle&& other );
+
+    // Requests the search to stop, best move of the last completed iteration becomes the result
+    void stop();
+    // Blocks until the search finishes, searches with infinite limits have to be stopped first
+    void wait();
+    // Pondered move was played, search continues as a normal timed search
+    void ponderHit();
+    bool isFinished() const;
+    std::shared_future<MoveContent> bestMove() const { return bestMove_; }
+
+private:
+    // Kept on the heap, so the search thread does not depend on where the handle is moved
+    struct State {
+        Board board;
+        Search search;
+        std::atomic<bool> stop = false;
+        std::promise<MoveContent> result;
+    };
+    std::unique_ptr<State> state_;
+    std::shared_future<MoveContent> bestMove_;
+    std::thread thread_;
+};
 
 class Engine {
 public:
@@ -15,13 +61,28 @@ public:
     void newGame( std::string fen );
     bool makeMove( SquareIndex src, SquareIndex dest, PieceType promotion = EMPTY );
     PieceColor whooseMove() const;
+    // Book moves are played before searching, throws if the book cannot be opened
+    void loadOpeningBook( const std::string &path );
+    MoveContent getBestMove( int depth );
+    // Best limits.multiPv lines of the current position ranked from the best, opening book is not used
+    std::vector<PvLine> getBestLines( const SearchLimits& limits );
+    // Searches the current position on a separate thread, onInfo is called from the search thread
+    SearchHandle startSearch( const SearchLimits& limits, SearchCallback onInfo = nullptr );
+    // Searches the position after the expected opponent's move on the opponent's time, throws if the move is illegal
+    SearchHandle startPondering( const MoveContent& expectedMove, const SearchLimits& limits,
+                                 SearchCallback onInfo = nullptr );
 
     std::unique_ptr<Board> board;
     std::stack<MoveContent> moveHistory;
     PieceValidMoves moveGenerator;
+    std::unique_ptr<OpeningBook> openingBook;
+    Search search;
 
 private:
     std::unique_ptr<Board> _previousBoard;
+
+    bool isLegalMove( const MoveContent &move );
+    std::optional<MoveContent> getBookMove();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef EPD_H
+#define EPD_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "MoveContent.h"
+#include "Search.h"
+
+// Test position with its best moves (bm) and moves to avoid (am) in SAN or UCI notation
+struct EpdPosition {
+    std::string id;
+    std::string fen;
+    std::vector<std::string> bestMoves;
+    std::vector<std::string> avoidMoves;
+};
+
+// Result of a single position, solution values are -1 if the position was not solved
+struct EpdResult {
+    std::string id;
+    MoveContent move;
+    bool solved;
+    int64_t timeToSolution;  // Milliseconds since the start of the search until the final correct move was found
+    int64_t nodesToSolution;
+    int64_t time;  // Milliseconds
+    uint64_t nodes;
+};
+
+struct EpdReport {
+    std::vector<EpdResult> results;  // In the order of the positions
+    int solved;
+    uint64_t nodes;
+    int64_t time;  // Wall time of the whole suite, milliseconds
+    uint64_t nps;  // Nodes of all positions per second of wall time
+};
+
+/**
+ * Test suite of EPD positions searched concurrently by a pool of threads.
+ * Every position is searched single threaded within the same limits, the pool runs one position per thread.
+ * Position is solved if the final move is one of the best moves and none of the moves to avoid.
+ */
+class EpdSuite {
+public:
+    EpdSuite() {}
+    // Reads one position per line, empty lines and lines starting with # are skipped, throws on invalid lines
+    // Positions without id are identified by their line numbers
+    EpdSuite( std::istream &in );
+
+    void add( const EpdPosition &position ) { positions_.push_back( position ); }
+    const std::vector<EpdPosition> &positions() const { return positions_; }
+
+    EpdReport run( const SearchLimits &limits, int threads ) const;
+
+    // Parses the four FEN fields followed by semicolon terminated operations, throws on invalid line
+    static EpdPosition parse( const std::string &line );
+    // Returns true if the move is described by the SAN or UCI notation, board has to have valid moves calculated
+    static bool matchesMove( const Board &board, const MoveContent &move, const std::string &notation );
+    static void printReport( const EpdReport &report, std::ostream &out );
+
+private:
+    std::vector<EpdPosition> positions_;
+
+    static bool isCorrect( const EpdPosition &position, const Board &board, const MoveContent &move );
+    static EpdResult runPosition( const EpdPosition &position, const SearchLimits &limits, Search &search );
+};
+
+#endif
@@ -1,8 +1,50 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include <array>
+
 #include "Board.h"
+#include "PawnHash.h"
+
+// Counts of the pawn structure terms indexed by PieceColor, evaluation is their sum weighted by the parameters
+struct PawnTerms {
+    int doubled[2];
+    int isolated[2];
+    int backward[2];
+    int passed[2][8];  // Indexed by the rank of the pawn as seen from its owner's side
+    int shield[2];     // Pawns in front of the king
+};
 
 class Evaluation {
 public:
     Evaluation() = delete;
 
     static int evaluateBoard( const Board &board );
-};
\ No newline at end of file
+
+    // Full recalculation of the values that Board keeps updated incrementally
+    static int computeScore( const Board &board, GameStage stage );
+    static uint64_t computeMaterialKey( const Board &board );
+    static uint64_t computePawnKey( const Board &board );
+    static std::array<SquareIndex, 2> findKingSquares( const Board &board );
+
+    // Pawn structure evaluation, cached in the pawn hash table of the calling thread
+    static const PawnEntry &probePawnStructure( const Board &board );
+    static PawnHashTable &getPawnHashTable();
+    // Size of the pawn hash tables in entries, has to be a power of two, applied on the next probe of every thread
+    static void setPawnHashSize( std::size_t size );
+    // Pawn structure terms of the position, computed without the pawn hash table
+    static PawnTerms countPawnTerms( const Board &board );
+
+    // Material and piece square score of a single piece, positive for white and negative for black
+    static int pieceSquareScore( GameStage stage, PieceColor color, PieceType type, SquareIndex square ) {
+        const SquareIndex tableSquare = color == WHITE ? square : 63 - square;
+        const int score = PIECE_VALUES[type] + PIECE_SQUARE_TABLES[stage][type][tableSquare];
+        return color == WHITE ? score : -score;
+    }
+
+private:
+    static void evaluatePawnStructure( const Board &board, PawnEntry &entry );
+    static void countPawns( const Board &board, PawnEntry &entry, PawnTerms &terms );
+};
+
+#endif
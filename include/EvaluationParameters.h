@@ -0,0 +1,187 @@
+#ifndef EVALUATION_PARAMETERS_H
+#define EVALUATION_PARAMETERS_H
+
+#include <cstdint>
+
+// Evaluation weights, regenerated by chess-cli tune
+
+/* ------------------------------ PIECE VALUES ------------------------------ */
+
+auto const PAWN_VALUE = 100;
+auto const KNIGHT_VALUE = 300;
+auto const BISHOP_VALUE = 325;
+auto const ROOK_VALUE = 500;
+auto const QUEEN_VALUE = 900;
+auto const KING_VALUE = 32767;
+
+// Piece values indexed by PieceType
+const int PIECE_VALUES[7] = { 0, ROOK_VALUE, KNIGHT_VALUE, BISHOP_VALUE, QUEEN_VALUE, KING_VALUE, PAWN_VALUE };
+
+/* ------------------------ PAWN STRUCTURE EVALUATION ----------------------- */
+
+// Middle game and end game values indexed by GameStage
+const int DOUBLED_PAWN_PENALTY[2] = { 10, 20 };
+const int ISOLATED_PAWN_PENALTY[2] = { 10, 15 };
+const int BACKWARD_PAWN_PENALTY[2] = { 8, 10 };
+const int PAWN_SHIELD_BONUS[2] = { 10, 0 };
+
+// Passed pawn bonus indexed by GameStage and the rank of the pawn as seen from its owner's side (0 is the first rank)
+const int PASSED_PAWN_BONUS[2][8] = {
+    { 0, 0, 5, 10, 20, 35, 60, 0 },
+    { 0, 5, 10, 20, 40, 70, 110, 0 },
+};
+
+/* --------------------------- MATERIAL IMBALANCE --------------------------- */
+
+auto const BISHOP_PAIR_BONUS = 40;
+auto const KNIGHT_PAWN_ADJUSTMENT = 6;  // Knight value change per own pawn above five
+auto const ROOK_PAWN_ADJUSTMENT = -12;  // Rook value change per own pawn above five
+
+/* ---------------------- SQUARE PIECE EVALUATION MAPS ---------------------- */
+
+// Tables are seen from the white side, square 0 is a8
+// clang-format off
+const int8_t PAWN_TABLE[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  27,  27,  10,   5,   5,
+      0,   0,   0,  25,  25,   0,   0,   0,
+      5,  -5, -10,   0,   0, -10,  -5,   5,
+      5,  10,  10, -25, -25,  10,  10,   5,
+      0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+const int8_t KNIGHT_TABLE[64] = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -20, -30, -30, -20, -40, -50,
+};
+
+const int8_t BISHOP_TABLE[64] = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+     20, -10, -40, -10, -10, -40, -10, -20,
+};
+
+const int8_t ROOK_TABLE[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,  10,  10,  10,  10,  10,  10,   5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0,
+};
+
+const int8_t QUEEN_TABLE[64] = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+};
+
+const int8_t KING_TABLE[64] = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20,
+};
+
+const int8_t PAWN_END_GAME_TABLE[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     80,  80,  80,  80,  80,  80,  80,  80,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     30,  30,  30,  30,  30,  30,  30,  30,
+     20,  20,  20,  20,  20,  20,  20,  20,
+     10,  10,  10,  10,  10,  10,  10,  10,
+     10,  10,  10,  10,  10,  10,  10,  10,
+      0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+const int8_t KNIGHT_END_GAME_TABLE[64] = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50,
+};
+
+const int8_t BISHOP_END_GAME_TABLE[64] = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,  10,  15,  15,  10,   5, -10,
+    -10,   5,  10,  15,  15,  10,   5, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20,
+};
+
+const int8_t ROOK_END_GAME_TABLE[64] = {
+      5,   5,   5,   5,   5,   5,   5,   5,
+     10,  10,  10,  10,  10,  10,  10,  10,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+const int8_t QUEEN_END_GAME_TABLE[64] = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+    -10,   5,  10,  10,  10,  10,   5, -10,
+     -5,   5,  10,  15,  15,  10,   5,  -5,
+     -5,   5,  10,  15,  15,  10,   5,  -5,
+    -10,   5,  10,  10,  10,  10,   5, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+};
+
+const int8_t KING_END_GAME_TABLE[64] = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50,
+};
+
+// clang-format on
+
+/* -------------------- PIECE SQUARE TABLES BY GAME STAGE ------------------- */
+
+// Tables indexed by GameStage and PieceType
+const int8_t* const PIECE_SQUARE_TABLES[2][7] = {
+    { nullptr, ROOK_TABLE, KNIGHT_TABLE, BISHOP_TABLE, QUEEN_TABLE, KING_TABLE, PAWN_TABLE },
+    { nullptr, ROOK_END_GAME_TABLE, KNIGHT_END_GAME_TABLE, BISHOP_END_GAME_TABLE, QUEEN_END_GAME_TABLE,
+      KING_END_GAME_TABLE, PAWN_END_GAME_TABLE },
+};
+
+#endif
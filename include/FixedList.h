@@ -0,0 +1,56 @@
+#ifndef FIXED_LIST_H
+#define FIXED_LIST_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * List with a capacity fixed at compile time, stored inline so it never allocates.
+ * Items past the size are left uninitialized, creating or clearing the list costs nothing.
+ * Only trivially copyable items are supported, copying the list copies the whole storage.
+ */
+template <typename T, std::size_t Capacity>
+class FixedList {
+    static_assert( std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                   "FixedList items are copied as raw storage" );
+    static_assert( Capacity <= UINT16_MAX, "FixedList size is stored in 16 bits" );
+
+public:
+    FixedList() : size_( 0 ) {}
+
+    void push_back( const T &item ) {
+        assert( size_ < Capacity );
+        items_[size_++] = item;
+    }
+    void pop_back() { size_--; }
+    void clear() { size_ = 0; }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    T &operator[]( std::size_t i ) { return items_[i]; }
+    const T &operator[]( std::size_t i ) const { return items_[i]; }
+    T &front() { return items_[0]; }
+    const T &front() const { return items_[0]; }
+    T &back() { return items_[size_ - 1]; }
+    const T &back() const { return items_[size_ - 1]; }
+
+    T *begin() { return items_; }
+    T *end() { return items_ + size_; }
+    const T *begin() const { return items_; }
+    const T *end() const { return items_ + size_; }
+    const T *cbegin() const { return items_; }
+    const T *cend() const { return items_ + size_; }
+
+private:
+    uint16_t size_;
+    // Union keeps the items from being constructed with the list
+    union {
+        T items_[Capacity];
+    };
+};
+
+#endif
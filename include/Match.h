@@ -0,0 +1,89 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "Search.h"
+
+// Engine configuration of one side of the match, its limits apply to every move on top of the match control
+struct MatchPlayer {
+    std::string name;
+    SearchLimits limits;
+    int threads = 1;
+};
+
+struct MatchOptions {
+    int games = 2;        // Played in pairs, both players play each opening with both colours
+    int concurrency = 1;  // Games played at the same time
+    int time = 0;         // Clock time of the game, milliseconds, zero for no clock
+    int increment = 0;    // Milliseconds per move
+    uint64_t nodes = 0;   // Nodes per move, zero for no limit
+    int maxMoves = 200;   // Game is drawn after this many full moves
+
+    // Game is drawn if both players score it within drawScore for drawMoveCount moves after drawMoveNumber
+    int drawMoveNumber = 40;
+    int drawMoveCount = 8;
+    int drawScore = 10;
+
+    // Sequential probability ratio test of H0: elo = elo0 against H1: elo = elo1, stops the match once decided
+    bool sprt = false;
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;  // Probability of accepting H1 if H0 is true
+    double beta = 0.05;   // Probability of accepting H0 if H1 is true
+};
+
+// Result of the match from the point of view of the first player
+struct MatchReport {
+    int wins;
+    int draws;
+    int losses;
+    double elo;
+    double eloError;  // Half of the 95% confidence interval
+    double llr;       // Log likelihood ratio of the SPRT
+    double lowerBound;
+    double upperBound;
+    int sprtResult;  // 1 if H1 is accepted, -1 if H0 is accepted, 0 if the test continues
+};
+
+using MatchCallback = std::function<void( const MatchReport& )>;
+
+/**
+ * Self-play match between two engine configurations, played in-process by a pool of threads.
+ * Every game starts from an opening position, each opening is played twice with the colours swapped.
+ * Games end with a mate, a stalemate or a draw by rule (fifty moves, repetition, insufficient material),
+ * or are adjudicated when a player announces a mate, when both players score the game as a draw for long
+ * enough, when the move limit is reached or when a player runs out of time.
+ */
+class Match {
+public:
+    // Openings are FEN strings, the initial position is used if there are none
+    Match( const MatchPlayer& first, const MatchPlayer& second, const std::vector<std::string>& openings,
+           const MatchOptions& options );
+
+    // onGame is called after every game with the current result, never by two threads at once
+    MatchReport run( const MatchCallback& onGame = nullptr ) const;
+
+    // Returns 1 if white won, 0 for a draw and -1 if black won, searches have to belong to the calling thread
+    int playGame( const std::string& opening, const MatchPlayer& white, const MatchPlayer& black, Search& whiteSearch,
+                  Search& blackSearch ) const;
+
+    static MatchReport makeReport( int wins, int draws, int losses, const MatchOptions& options );
+    static void printReport( const MatchReport& report, std::ostream& out );
+
+private:
+    MatchPlayer first_;
+    MatchPlayer second_;
+    std::vector<std::string> openings_;
+    MatchOptions options_;
+
+    static double scoreToElo( double score );
+    static double eloToScore( double elo );
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+
+// Specialized evaluation of a known endgame, returns score positive for white
+using EndgameFunction = int ( * )( const Board &board, PieceColor strongSide );
+
+// Evaluation terms depending only on the material on the board
+struct MaterialEntry {
+    int phase;       // Game phase, TOTAL_PHASE in the opening and 0 in pawn endgames
+    int imbalance;   // Material imbalance adjustment, positive for white
+    bool knownDraw;  // Neither side can force a mate
+    PieceColor strongSide;
+    EndgameFunction endgame;  // Replaces the normal evaluation if set
+};
+
+/**
+ * Precalculated material table indexed by Board::materialKey.
+ * Material key packs counts of every piece type and color into 4 bit fields (see MATERIAL_KEY_SHIFTS),
+ * so it can be updated incrementally by adding and subtracting materialKeyUnit.
+ * Material configurations reachable only through underpromotion or multiple queens are calculated on demand.
+ */
+class MaterialTable {
+public:
+    static MaterialTable &getInstance() {
+        static MaterialTable instance;
+        return instance;
+    }
+
+    const MaterialEntry &probe( uint64_t materialKey ) const;
+
+    static uint64_t materialKeyUnit( PieceColor color, PieceType type ) {
+        return type == KING || type == EMPTY ? 0 : 1ULL << ( 4 * ( 5 * color + MATERIAL_KEY_SHIFTS[type] ) );
+    }
+    static int pieceCount( uint64_t materialKey, PieceColor color, PieceType type ) {
+        return ( materialKey >> ( 4 * ( 5 * color + MATERIAL_KEY_SHIFTS[type] ) ) ) & 0xF;
+    }
+
+private:
+    MaterialTable();
+    MaterialTable( MaterialTable &other ) = delete;
+
+    // Position of the piece count in the material key for both colors, indexed by PieceType
+    static constexpr int MATERIAL_KEY_SHIFTS[7] = { 0, 3, 1, 2, 4, 0, 0 };
+
+    // Maximal piece counts stored in the table, indexed by PieceType
+    static constexpr int MAX_COUNTS[7] = { 0, 2, 2, 2, 1, 1, 8 };
+    static constexpr int ENTRIES_PER_COLOR = 3 * 3 * 3 * 2 * 9;
+
+    std::vector<MaterialEntry> entries_;
+
+    static int colorIndex( uint64_t materialKey, PieceColor color );
+    static MaterialEntry computeEntry( uint64_t materialKey );
+};
+
+#endif
@@ -1,10 +1,15 @@
 #ifndef MOVE_H
 #define MOVE_H
 
+#include <optional>
 #include <string>
+#include <string_view>
 
+#include "FixedList.h"
 #include "Piece.h"
 
+class Board;
+
 /* ---------------------------- MoveContent class --------------------------- */
 
 class MoveContent {
@@ -23,11 +28,20 @@ public:
     bool isEnPassantCapture;
     int score;
 
-    // TODO:
-    std::string toPGN() const;
+    // Standard algebraic notation (Nbd7, exd8=Q+, O-O#), board is the position before the move with valid moves
+    std::string toPGN( const Board &board ) const;
+    // Long algebraic notation used by UCI (e2e4, e7e8q for promotion)
+    std::string toUCI() const;
+
+    // Legal move described by the standard algebraic notation, nullopt if it is illegal or ambiguous
+    static std::optional<MoveContent> fromPGN( const Board &board, std::string_view san );
 
     static int compareMin( const MoveContent &m1, const MoveContent &m2 );
     static int compareMax( const MoveContent &m1, const MoveContent &m2 );
 };
 
+// Pseudo legal moves of a position, promotions counted per piece, fit with a margin
+static const int MAX_MOVES = 256;
+using MoveList = FixedList<MoveContent, MAX_MOVES>;
+
 #endif
\ No newline at end of file
@@ -16,22 +16,34 @@ public:
 
     // Generate all pseudo legal moves for the given board filling Piece.validMoves vectors
     int generateValidMoves( Board &board );
+    // Same for a side to move known at compile time, Us has to be board.sideToMove (asserted in debug builds)
+    template <PieceColor Us>
+    int generateValidMoves( Board &board );
 
     // This method looks at the board and determines if previously made move didnt leave the king in check.
     // All pseudo legal moves generated with generateValidMoves method have to be validated for full legality!
     bool validateBoard( const Board &board ) const;
 
 private:
-    // Kings and pawns have different restrictions on moves so they are handled separately
+    // Moves of a piece of the colour Us, colour is a template parameter so the attack board and the checked king
+    // are chosen at compile time. Kings and pawns have different restrictions on moves so they are handled separately
+    template <PieceColor Us>
+    int generateValidPieceMoves( Board &board, SquareIndex srcSquare );
+    template <PieceColor Us>
     int generateValidKingMoves( Board &board, SquareIndex srcSquare );
+    template <PieceColor Us>
     int generateValidCastlingMoves( Board &board, SquareIndex srcSquare );
+    template <PieceColor Us>
     int generateValidPawnMoves( Board &board, SquareIndex srcSquare );
 
     // Analyze methods will record information about the board while looking at the move
     // They will return true if the move is valid
+    template <PieceColor Us>
     bool analyzeMove( Board &board, SquareIndex srcSquare, SquareIndex dest );
+    template <PieceColor Us>
     bool analyzePawnMove( Board &board, SquareIndex srcSquare, SquareIndex destSquare );
-    bool analyzeCastlingMove( Board &board, SquareIndex srcSquare, SquareIndex destSquare );
+    template <PieceColor Us, bool IsKingSide>
+    bool analyzeCastlingMove( const Board &board ) const;
 
     // Only used for castling moves
     std::array<bool, 64> blackAttackBoard_;
@@ -0,0 +1,29 @@
+#ifndef PACKED_POSITION_H
+#define PACKED_POSITION_H
+
+#include <cstdint>
+
+#include "Common.h"
+
+/**
+ * Fixed size binary position record, created by Board::pack and read back by the Board constructor.
+ * Pieces are stored only for the occupied squares, so 32 pieces fit in 16 bytes next to the occupancy bitboard.
+ * Records are written in the host byte order, a file of them can be memory mapped and indexed directly.
+ */
+struct PackedPosition {
+    static constexpr int16_t NO_SCORE = INT16_MIN;
+    static constexpr int8_t NO_RESULT = INT8_MIN;
+
+    Bitboard occupancy;
+    uint8_t pieces[16];       // 4 bits per occupied square in the square order, color << 3 | PieceType
+    uint8_t flags;            // Side to move in bit 0, castling rights KQkq in bits 1 to 4
+    uint8_t enPassantSquare;  // NULL_SQUARE if there is none
+    uint8_t halfMoveClock;
+    int8_t result;  // 1 if white won, 0 for a draw, -1 if black won or NO_RESULT
+    uint16_t fullMoveNumber;
+    int16_t score;  // Centipawns from the white point of view or NO_SCORE
+};
+
+static_assert( sizeof( PackedPosition ) == 32, "PackedPosition records have to be 32 bytes" );
+
+#endif
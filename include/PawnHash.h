@@ -0,0 +1,46 @@
+#ifndef PAWN_HASH_H
+#define PAWN_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Common.h"
+
+// Pawn structure evaluation cached by Board::pawnKey
+struct PawnEntry {
+    uint64_t key;
+    int score[2];  // Middle game and end game pawn structure score, positive for white
+    Bitboard pawns[2];
+    Bitboard passedPawns[2];
+    Bitboard pawnAttacks[2];
+};
+
+/**
+ * Direct mapped hash table of pawn structure evaluations.
+ * Pawn structure rarely changes between search nodes, so most probes are hits.
+ * Tables are not synchronized, every thread should use its own table.
+ */
+class PawnHashTable {
+public:
+    PawnHashTable( std::size_t size = PAWN_HASH_TABLE_SIZE );
+
+    // Returns the entry for the key, found is set to false if the caller has to (re)calculate and store the entry
+    PawnEntry &probe( uint64_t key, bool &found );
+    void clear();
+
+    std::size_t size() const { return entries_.size(); }
+    uint64_t probes() const { return probes_; }
+    uint64_t hits() const { return hits_; }
+    // Fraction of the entries holding a pawn structure, counted by probe so it is cheap to call
+    double usage() const { return double( used_ ) / entries_.size(); }
+
+private:
+    std::vector<PawnEntry> entries_;
+    uint64_t mask_;
+    uint64_t probes_;
+    uint64_t hits_;
+    std::size_t used_;
+};
+
+#endif
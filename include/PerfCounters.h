@@ -0,0 +1,45 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+// Hardware events counted by PerfCounters
+enum PerfEvent { PERF_CYCLES, PERF_INSTRUCTIONS, PERF_BRANCH_MISSES, PERF_L1D_MISSES, PERF_LLC_MISSES, PERF_EVENTS };
+
+struct PerfReading {
+    std::array<uint64_t, PERF_EVENTS> values{};
+    std::array<bool, PERF_EVENTS> available{};  // False if the event could not be counted
+
+    double ipc() const;  // Instructions per cycle, zero if either is unavailable
+    bool isAvailable() const;
+};
+
+/**
+ * Hardware performance counters of the calling thread read with perf_event_open (Linux only).
+ * Every event is opened separately, so events which are not supported by the CPU, the kernel or the
+ * permissions (kernel.perf_event_paranoid) are reported as unavailable while the others are counted.
+ * Counts are scaled when the kernel multiplexes more events than the CPU has counters.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters( const PerfCounters & ) = delete;
+    PerfCounters &operator=( const PerfCounters & ) = delete;
+
+    bool isAvailable() const;
+    // Resets and starts all available counters
+    void start();
+    // Stops the counters and returns the counts since start
+    PerfReading stop();
+
+    // Prints the counts per node, or a note that the counters are unavailable
+    static void printReport( const PerfReading &reading, uint64_t nodes, std::ostream &out );
+
+private:
+    std::array<int, PERF_EVENTS> descriptors_;
+};
+
+#endif
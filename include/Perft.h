@@ -0,0 +1,73 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "Movegen.h"
+
+static const double PERFT_REGRESSION_THRESHOLD = 20.0;  // Percent of the baseline nodes per second
+
+// Reference position with the known number of leaf nodes at the depth
+struct PerftPosition {
+    std::string name;
+    std::string fen;
+    int depth;
+    uint64_t expected;
+};
+
+struct PerftResult {
+    std::string name;
+    int depth;
+    uint64_t nodes;
+    uint64_t expected;
+    int64_t time;  // Microseconds
+    uint64_t nps;
+};
+
+struct PerftReport {
+    std::vector<PerftResult> results;  // In the order of the positions
+    int failed;                        // Positions with a wrong node count
+    uint64_t nodes;
+    int64_t time;  // Microseconds
+    uint64_t nps;
+};
+
+// Position which got slower than its baseline by more than the threshold
+struct PerftRegression {
+    std::string name;
+    uint64_t baselineNps;
+    uint64_t nps;
+    double change;  // Percent, negative if slower
+};
+
+/**
+ * Move generator correctness and speed check on the standard perft positions
+ * (https://www.chessprogramming.org/Perft_Results) and on promotion, en passant and castling edge cases.
+ * Results are written as JSON, a stored result is the baseline for detecting throughput regressions.
+ */
+class Perft {
+public:
+    // Number of leaf nodes of the legal move tree, board has to have valid moves calculated
+    static uint64_t count( Board &board, int depth, PieceValidMoves &generator );
+
+    static const std::vector<PerftPosition> &positions();
+    // Positions are run one after another on the calling thread
+    static PerftReport run( const std::vector<PerftPosition> &positions = Perft::positions() );
+
+    // One result object per line, so that readBaseline does not need a general JSON parser
+    static void writeJson( const PerftReport &report, std::ostream &out );
+    // Returns nodes per second by position name of a file written by writeJson, throws on invalid result
+    static std::map<std::string, uint64_t> readBaseline( std::istream &in );
+    static std::vector<PerftRegression> compare( const PerftReport &report,
+                                                 const std::map<std::string, uint64_t> &baseline,
+                                                 double threshold = PERFT_REGRESSION_THRESHOLD );
+
+    static void printReport( const PerftReport &report, std::ostream &out );
+};
+
+#endif
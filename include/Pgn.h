@@ -0,0 +1,56 @@
+#ifndef PGN_H
+#define PGN_H
+
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Board.h"
+
+static const std::size_t PGN_CHUNK_SIZE = 1 << 20;  // Bytes read from the stream at once
+
+/**
+ * Game read by PgnReader.
+ * All views point into the reader's buffer and stay valid only until the next game is read,
+ * so reading a game does not allocate once the vectors have grown to the size of the longest game.
+ */
+struct PgnGame {
+    std::vector<std::pair<std::string_view, std::string_view>> tags;  // Name and value
+    std::vector<std::string_view> moves;                               // SAN moves of the main line
+    std::string_view result;                                           // 1-0, 0-1, 1/2-1/2, * or empty if missing
+
+    std::string_view tag( std::string_view name ) const;
+    // Position from the FEN tag or the initial position, with valid moves calculated
+    Board startingBoard() const;
+    void clear();
+};
+
+/**
+ * Streaming reader of PGN files of any size.
+ * Input is read in chunks into a buffer that grows only if a single game does not fit in it.
+ * Comments, variations, move numbers and numeric annotation glyphs are skipped.
+ */
+class PgnReader {
+public:
+    PgnReader( std::istream &in, std::size_t chunkSize = PGN_CHUNK_SIZE );
+    PgnReader( PgnReader &other ) = delete;
+
+    // Reads the next game into the given game reusing its storage, returns false at the end of the input
+    bool next( PgnGame &game );
+
+private:
+    std::istream &in_;
+    std::vector<char> buffer_;
+    std::size_t begin_;  // Start of the unread data in the buffer
+    std::size_t end_;    // End of the data read from the stream
+    bool isEndOfInput_;
+
+    // Returns the number of bytes of the parsed game or nullopt if the game continues beyond the buffered data
+    std::optional<std::size_t> parseGame( std::string_view text, PgnGame &game ) const;
+    void readChunk();
+};
+
+#endif
@@ -1,9 +1,10 @@
 #ifndef PIECE_H
 #define PIECE_H
 
-#include <vector>
-
 #include "Common.h"
+#include "FixedList.h"
+
+static const int MAX_PIECE_MOVES = 27;  // Queen in the middle of an empty board
 
 class Piece {
 public:
@@ -19,7 +20,7 @@ public:
     int defendedValue;
     int value;
     int actionValue;
-    std::vector<SquareIndex> validMoves;
+    FixedList<SquareIndex, MAX_PIECE_MOVES> validMoves;  // Inline, so copying a Board does not allocate
 
     // helper methods for creating Pieces
     static int calculatePieceValue( PieceType piece );
@@ -0,0 +1,51 @@
+#ifndef POLYGLOT_H
+#define POLYGLOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "MoveContent.h"
+
+// Single book entry, stored as 16 big endian bytes sorted by key in the book file
+struct PolyglotEntry {
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+    uint32_t learn;
+};
+
+/**
+ * Polyglot (.bin) opening book.
+ * The book file is memory mapped read only, so opening even a large book is instant
+ * and its pages are shared by all engine processes using the same book.
+ */
+class OpeningBook {
+public:
+    OpeningBook( const std::string &path );
+    ~OpeningBook();
+    OpeningBook( OpeningBook &other ) = delete;
+    OpeningBook &operator=( OpeningBook &other ) = delete;
+
+    // Returns a book move for the board, picked randomly by weight or the heaviest one if bestMove is set
+    std::optional<MoveContent> probe( const Board &board, bool bestMove = false ) const;
+    // Returns all book moves for the board with their weights
+    std::vector<std::pair<MoveContent, int>> getMoves( const Board &board ) const;
+    std::size_t size() const { return size_ / ENTRY_SIZE; }
+
+    static uint64_t polyglotKey( const Board &board );
+
+private:
+    static constexpr std::size_t ENTRY_SIZE = 16;
+
+    const unsigned char *data_;
+    std::size_t size_;
+
+    PolyglotEntry readEntry( std::size_t index ) const;
+    static MoveContent decodeMove( const Board &board, uint16_t move );
+};
+
+#endif
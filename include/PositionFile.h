@@ -0,0 +1,50 @@
+#ifndef POSITION_FILE_H
+#define POSITION_FILE_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include "Board.h"
+#include "PackedPosition.h"
+
+/**
+ * Dataset of PackedPosition records.
+ * The file is memory mapped read only, so opening it is instant regardless of its size
+ * and any position can be read without parsing.
+ */
+class PositionFile {
+public:
+    PositionFile( const std::string &path );
+    ~PositionFile();
+    PositionFile( PositionFile &other ) = delete;
+    PositionFile &operator=( PositionFile &other ) = delete;
+
+    std::size_t size() const { return size_; }
+    const PackedPosition &operator[]( std::size_t index ) const { return positions_[index]; }
+    const PackedPosition *begin() const { return positions_; }
+    const PackedPosition *end() const { return positions_ + size_; }
+    Board board( std::size_t index ) const { return Board( positions_[index] ); }
+
+private:
+    const PackedPosition *positions_;
+    std::size_t size_;
+};
+
+// Appends PackedPosition records to a file, throws std::runtime_error if the file cannot be written
+class PositionWriter {
+public:
+    PositionWriter( const std::string &path, bool append = false );
+
+    void write( const PackedPosition &position );
+    void write( const Board &board, int score = PackedPosition::NO_SCORE, int result = PackedPosition::NO_RESULT ) {
+        write( board.pack( score, result ) );
+    }
+    void flush();
+
+private:
+    std::string path_;
+    std::ofstream out_;
+};
+
+#endif
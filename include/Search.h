@@ -1,9 +1,22 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iosfwd>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "Board.h"
 #include "Evaluation.h"
+#include "FixedList.h"
 #include "MoveContent.h"
 #include "Movegen.h"
 
@@ -11,22 +24,204 @@
 static const int POSITIVE_INFINITY = std::numeric_limits<int>::max();
 static const int NEGATIVE_INFINITY = std::numeric_limits<int>::min();
 
+/* ---------------------- Proof-number search constants --------------------- */
+static const uint32_t PN_INFINITY = 100'000'000;
+static const int MATE_SEARCH_MAX_NODES = 2'000'000;
+
+/* ------------------------- Search limits constants ------------------------ */
+static const int MAX_SEARCH_DEPTH = 64;
+static const int NODES_BETWEEN_CHECKS = 1024;  // Limits and stop requests are checked this often
+static const int INFO_INTERVAL = 1000;         // Milliseconds between progress reports
+static const int MOVES_TO_GO_ESTIMATE = 30;    // Assumed number of moves left if the time control does not tell
+static const int MOVE_OVERHEAD = 30;           // Milliseconds reserved for communication
+
+// Principal variation below the root, kept inline so the search does not allocate
+using PvList = FixedList<MoveContent, MAX_SEARCH_DEPTH>;
+
+// State of a single ply of the search, the plies of a thread are consecutive in memory
+struct alignas( 64 ) SearchPly {
+    Board board;      // Position after the move leading to the ply, the parent position stays untouched
+    MoveList moves;   // Pseudo legal moves with their ordering scores
+    PvList pv;        // Principal variation from this ply
+};
+
+// Root, a ply for every level of the deepest search and the leaves evaluated below it
+static const int PLY_STACK_SIZE = MAX_SEARCH_DEPTH + 2;
+
+// Limits of a single search, zero means no limit
+struct SearchLimits {
+    int depth = MAX_SEARCH_DEPTH;
+    uint64_t nodes = 0;
+    int moveTime = 0;                        // Milliseconds
+    std::array<int, 2> time = { 0, 0 };      // Remaining clock time indexed by PieceColor, milliseconds
+    std::array<int, 2> increment = { 0, 0 };  // Increment per move indexed by PieceColor, milliseconds
+    int movesToGo = 0;
+    bool infinite = false;
+    int multiPv = 1;  // Number of best moves searched with exact scores
+};
+
+// Line of the search result, lines of a multi-PV search are ranked from the best
+struct PvLine {
+    int score;                    // Positive for white, POSITIVE_INFINITY or NEGATIVE_INFINITY for mate
+    std::vector<MoveContent> pv;  // Principal variation starting with the move
+};
+
+// Progress of the search, reported after every iteration and periodically during long iterations
+struct SearchInfo {
+    int depth;
+    int score;  // Positive for white, POSITIVE_INFINITY or NEGATIVE_INFINITY for mate
+    uint64_t nodes;
+    int64_t time;  // Milliseconds
+    uint64_t nps;
+    MoveContent bestMove;
+    std::vector<MoveContent> pv;  // Principal variation starting with the best move
+    std::vector<PvLine> lines;    // All lines of a multi-PV search, the first one is the principal variation
+    bool completed;               // False for periodic reports in the middle of an iteration
+};
+
+using SearchCallback = std::function<void( const SearchInfo& )>;
+
+// Iteration of the iterative deepening search
+struct SearchIteration {
+    int depth;
+    uint64_t nodes;  // Nodes of this iteration only
+    int64_t time;    // Milliseconds spent in this iteration
+};
+
+/**
+ * Counters of a single search, cheap enough to be always collected.
+ * Every thread counts into its own SearchStats, they are summed when the search ends.
+ */
+struct SearchStats {
+    uint64_t nodes = 0;
+    uint64_t evaluations = 0;        // Leaf nodes evaluated statically
+    uint64_t cutoffs = 0;            // Beta cutoffs
+    uint64_t firstMoveCutoffs = 0;   // Beta cutoffs by the first legal move of the node
+    uint64_t materialDraws = 0;      // Nodes pruned as drawn by insufficient material
+    uint64_t bitbaseDraws = 0;       // Nodes pruned as drawn by the bitbases
+    uint64_t pawnHashProbes = 0;
+    uint64_t pawnHashHits = 0;
+    // Fraction of the pawn hash entries filled at the end of the search, every thread has its own table
+    // and the mean over the threads is reported
+    double pawnHashUsage = 0.0;
+    std::vector<SearchIteration> iterations;
+
+    double firstMoveCutoffRate() const { return cutoffs > 0 ? double( firstMoveCutoffs ) / cutoffs : 0.0; }
+    double pawnHashHitRate() const { return pawnHashProbes > 0 ? double( pawnHashHits ) / pawnHashProbes : 0.0; }
+    // Ratio of the nodes of the last two iterations, zero if there are fewer than two iterations
+    double effectiveBranchingFactor() const;
+
+    // Adds the counters of another thread, iterations and pawn hash usage are kept
+    SearchStats& operator+=( const SearchStats& other );
+    void print( std::ostream& out ) const;
+};
+
 class Search {
 public:
-    Search() {}
+    Search() : plies_( std::make_unique<SearchPly[]>( PLY_STACK_SIZE ) ) {}
+    ~Search();
     Search( Search& ) = delete;
     Search( Search&& ) = delete;
 
-    MoveContent getBestMove( const Board& examineBoard, int maxDepth, bool maximizingPlayer, int nodesExamined = 0,
-                             int nodesEvaluated = 0, int nodesPruned = 0 ) const;
+    // Searches work on the preallocated plies of the Search, so a Search runs a single search at a time
+    // Best move for the side to move of the board
+    MoveContent getBestMove( const Board& examineBoard, int maxDepth, SearchStats* stats = nullptr );
     std::vector<MoveContent> getPossibleMoves( const Board& board ) const;
+    // Same moves written to a preallocated list, used by the search which must not allocate
+    void getPossibleMoves( const Board& board, MoveList& moves ) const;
+    std::vector<MoveContent> findMate( const Board& examineBoard, int maxMoves,
+                                       int maxNodes = MATE_SEARCH_MAX_NODES ) const;
+
+    // Iterative deepening search within the limits, stops as soon as stop is set (also by the limits)
+    // Statistics of the search are stored to stats if it is given
+    MoveContent search( const Board& examineBoard, const SearchLimits& limits, std::atomic<bool>& stop,
+                        const SearchCallback& onInfo = nullptr, SearchStats* stats = nullptr );
+    std::vector<PvLine> searchLines( const Board& examineBoard, const SearchLimits& limits, std::atomic<bool>& stop,
+                                     const SearchCallback& onInfo = nullptr, SearchStats* stats = nullptr );
+    // Helper threads are started here and kept until the next change, so it must not be called while searching
+    void setThreads( int threads );
+    int getThreads() const { return threads_; }
+
+    // Search started while pondering ignores its time limit until the ponder hit, time is counted from the start
+    void startPondering() { pondering_ = true; }
+    void ponderHit();
+    bool isPondering() const { return pondering_; }
+    void waitForPonderHit() const { pondering_.wait( true ); }
 
 private:
     mutable PieceValidMoves generator;
+    // Preallocated state of every ply, each searching thread has its own Search and so its own plies
+    std::unique_ptr<SearchPly[]> plies_;
+    int threads_ = 1;
+    std::atomic<bool> pondering_ = false;
 
-    int alphaBeta( const Board& examineBoard, int depth, int alpha, int beta, bool maximizingPlayer, int& nodesExamined,
-                   int& nodesEvaluated, int& nodesPruned ) const;
+    // Work of a single iteration, called on every searching thread with its Search and its index (0 is the caller)
+    using ThreadTask = std::function<void( Search&, std::size_t )>;
+    // Helper threads wait for the tasks between the iterations, each one searches with its own Search
+    std::vector<std::unique_ptr<Search>> helpers_;
+    std::vector<std::thread> helperThreads_;
+    std::mutex helpersMutex_;
+    std::condition_variable helpersStart_;
+    std::condition_variable helpersDone_;
+    const ThreadTask* helpersTask_ = nullptr;
+    uint64_t helpersGeneration_ = 0;  // Incremented for every task, so each task is run exactly once
+    std::size_t helpersRunning_ = 0;
+    bool helpersExit_ = false;
+
+    void runOnAllThreads( const ThreadTask& task );
+    void helperLoop( std::size_t index, uint64_t generation );
+    void stopHelpers();
+
+    // State shared by all threads of a single search
+    struct SearchControl {
+        std::atomic<bool>* stop;
+        std::atomic<uint64_t> nodes;
+        uint64_t nodeLimit;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point deadline;
+        bool hasDeadline;
+        const std::atomic<bool>* pondering;
+        const SearchCallback* onInfo;
+        std::chrono::steady_clock::time_point lastInfo;
+        int depth;
+        MoveContent bestMove;
+        std::vector<MoveContent> pv;
+        std::vector<PvLine> lines;
+    };
+    SearchControl* control_ = nullptr;
+    bool reportsProgress_ = false;
+
+    void checkLimits( int nodes ) const;
+    int64_t elapsed() const;
+    SearchInfo makeInfo( int score, uint64_t nodes, bool completed ) const;
+
+    // Node of the proof-number search tree, children of a node are stored contiguously
+    struct ProofNode {
+        MoveContent move;
+        uint32_t parent;
+        uint32_t firstChild;
+        uint32_t childCount;
+        uint32_t proof;
+        uint32_t disproof;
+        int ply;
+        bool expanded;
+    };
+
+    bool proveMate( const Board& examineBoard, int maxPlies, int maxNodes, std::vector<ProofNode>& tree ) const;
+    void expandProofNode( std::vector<ProofNode>& tree, uint32_t nodeIndex, const Board& board, int maxPlies ) const;
+    void updateProofNumbers( std::vector<ProofNode>& tree, uint32_t nodeIndex ) const;
+    int countLegalMoves( const Board& board ) const;
+
+    template <PieceColor Us>
+    void getPossibleMoves( const Board& board, MoveList& moves ) const;
+    // Node of the search with the side to move Us, white maximizes and black minimizes the score
+    template <PieceColor Us>
+    int alphaBeta( const Board& examineBoard, int ply, int depth, int alpha, int beta, SearchStats& stats,
+                   PvList* pv = nullptr );
+    static void updatePv( PvList& pv, const MoveContent& move, const PvList& line );
     int quiescentSearch( const Board& board, int alpha, int beta, bool maximizingPlayer ) const;
 
     int endOfTheGameScore( const Board& board ) const;
 };
+
+#endif
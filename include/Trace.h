@@ -0,0 +1,97 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+static const std::size_t TRACE_BUFFER_SIZE = 1 << 16;  // Events per thread, has to be a power of two
+
+/* ------------------------------ Tracing macros ---------------------------- */
+
+// Scopes are recorded only in builds with ENGINE_TRACE defined, otherwise the macros compile to nothing
+#define TRACE_CONCAT_( a, b ) a##b
+#define TRACE_CONCAT( a, b ) TRACE_CONCAT_( a, b )
+#ifdef ENGINE_TRACE
+#define TRACE_SCOPE( name ) const TraceScope TRACE_CONCAT( traceScope, __LINE__ )( name )
+#else
+#define TRACE_SCOPE( name )
+#endif
+
+// Completed scope, times are nanoseconds since the start of the trace
+struct TraceEvent {
+    const char *name;  // Has to be a string literal
+    uint64_t start;
+    uint64_t duration;
+};
+
+/**
+ * Ring buffer of the events of a single thread.
+ * Only the owning thread writes, so recording is a plain store followed by a release of the event count.
+ * When the buffer is full the oldest events are overwritten.
+ */
+class TraceBuffer {
+public:
+    TraceBuffer( int threadId ) : threadId_( threadId ), events_( TRACE_BUFFER_SIZE ), count_( 0 ) {}
+
+    void record( const TraceEvent &event ) {
+        const uint64_t count = count_.load( std::memory_order_relaxed );
+        events_[count & ( TRACE_BUFFER_SIZE - 1 )] = event;
+        count_.store( count + 1, std::memory_order_release );
+    }
+
+    int threadId() const { return threadId_; }
+    // Events recorded so far, at most TRACE_BUFFER_SIZE of the latest ones are kept
+    std::vector<TraceEvent> events() const;
+
+private:
+    int threadId_;
+    std::vector<TraceEvent> events_;
+    std::atomic<uint64_t> count_;
+};
+
+/**
+ * Timeline of the scopes recorded by all threads, written in the Chrome trace_event format
+ * (chrome://tracing or https://ui.perfetto.dev open it).
+ * Every thread gets its own buffer on its first event, buffers outlive their threads until clear.
+ */
+class Trace {
+public:
+    static TraceBuffer &threadBuffer();
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start_ )
+            .count();
+    }
+
+    // Should be called when no thread is recording, events recorded at the same time may be incomplete
+    static void write( std::ostream &out );
+    // Drops all buffers, must not be called while any thread is recording
+    static void clear();
+
+    static constexpr bool isEnabled() {
+#ifdef ENGINE_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    static const std::chrono::steady_clock::time_point start_;
+};
+
+// Records the time between its construction and destruction
+class TraceScope {
+public:
+    TraceScope( const char *name ) : name_( name ), start_( Trace::now() ) {}
+    ~TraceScope() { Trace::threadBuffer().record( { name_, start_, Trace::now() - start_ } ); }
+    TraceScope( const TraceScope & ) = delete;
+
+private:
+    const char *name_;
+    uint64_t start_;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "Board.h"
+#include "PositionFile.h"
+
+static const int TUNER_SCALE_ITERATIONS = 40;  // Golden section steps of the search for the scaling constant
+
+/**
+ * Texel tuning of the evaluation parameters.
+ * Evaluation without the specialized endgames is linear in its parameters, so every position is stored as
+ * sparse counts of its evaluation terms and evaluated by a dot product with the parameter vector.
+ * Loss is the mean squared error between the game results and the win probabilities predicted
+ * from the evaluations, it is minimized by the Adam gradient descent with the loss computed on all threads.
+ */
+class Tuner {
+public:
+    // Parameters of the middle game or of both stages, end game parameter of a term is given by endGameIndex
+    static constexpr int PIECE_VALUES_INDEX = 0;                                    // Indexed by PieceType
+    static constexpr int PIECE_SQUARE_INDEX = PIECE_VALUES_INDEX + 7;               // Stage, PieceType, square
+    static constexpr int DOUBLED_PAWN_INDEX = PIECE_SQUARE_INDEX + 2 * 7 * 64;      // Indexed by GameStage
+    static constexpr int ISOLATED_PAWN_INDEX = DOUBLED_PAWN_INDEX + 2;              // Indexed by GameStage
+    static constexpr int BACKWARD_PAWN_INDEX = ISOLATED_PAWN_INDEX + 2;             // Indexed by GameStage
+    static constexpr int PAWN_SHIELD_INDEX = BACKWARD_PAWN_INDEX + 2;               // Indexed by GameStage
+    static constexpr int PASSED_PAWN_INDEX = PAWN_SHIELD_INDEX + 2;                 // Indexed by GameStage and rank
+    static constexpr int BISHOP_PAIR_INDEX = PASSED_PAWN_INDEX + 2 * 8;
+    static constexpr int KNIGHT_PAWN_INDEX = BISHOP_PAIR_INDEX + 1;
+    static constexpr int ROOK_PAWN_INDEX = KNIGHT_PAWN_INDEX + 1;
+    static constexpr int PARAMETER_COUNT = ROOK_PAWN_INDEX + 1;
+
+    // Parameters are initialized from the current evaluation constants
+    Tuner( int threads = 1 );
+
+    // Adds a position with the game result from the white point of view (1, 0.5 or 0)
+    // Positions drawn by material or evaluated by specialized endgames are skipped, false is returned for them
+    bool addPosition( const Board &board, double result );
+    // Adds all positions of the file with a known result
+    void addPositions( const PositionFile &file );
+    std::size_t size() const { return results_.size(); }
+
+    const std::vector<double> &parameters() const { return parameters_; }
+    // Evaluation of the added position with the current parameters, positive for white
+    double evaluate( std::size_t position ) const;
+    // Mean squared error of the win probabilities 1 / (1 + 10^(-scale * evaluation / 400))
+    double loss( double scale ) const { return computeLoss( scale, nullptr ); }
+    // Scaling constant minimizing the loss of the current parameters
+    double findScale() const;
+    // Runs the gradient descent, onIteration receives the iteration number and the loss before the step
+    void tune( int iterations, double scale, double learningRate,
+               const std::function<void( int, double )> &onIteration = nullptr );
+
+    // Writes EvaluationParameters.h with the rounded parameters
+    void writeParameters( std::ostream &out ) const;
+
+    static int endGameIndex( int index );
+
+private:
+    // Count of the evaluation term of one position, positive for white
+    struct Feature {
+        uint16_t index;
+        uint16_t endGameIndex;
+        int16_t count;
+    };
+
+    int threads_;
+    std::vector<double> parameters_;
+    // Features of the position i are features_[featureOffsets_[i]] to features_[featureOffsets_[i + 1] - 1]
+    std::vector<Feature> features_;
+    std::vector<uint64_t> featureOffsets_;
+    std::vector<uint8_t> phases_;
+    std::vector<float> results_;
+    std::vector<int> termCounts_;  // Dense counts of the position being added
+
+    double computeLoss( double scale, std::vector<double> *gradient ) const;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef UCI_H
+#define UCI_H
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "Board.h"
+#include "Movegen.h"
+#include "Search.h"
+
+static const char *const ENGINE_NAME = "chess";
+static const char *const ENGINE_AUTHOR = "MWronski12";
+
+/* ------------------------------- UCI options ------------------------------ */
+static const int DEFAULT_HASH_SIZE = 1;  // Megabytes
+static const int MAX_HASH_SIZE = 1024;
+static const int MAX_THREADS = 64;
+static const int MAX_MULTI_PV = 64;
+
+/**
+ * Universal Chess Interface front-end.
+ * Commands are read from the input stream and answered on the output stream.
+ * Searches run on a separate thread, so stop and isready are answered while searching.
+ */
+class Uci {
+public:
+    Uci( std::istream &in, std::ostream &out );
+    ~Uci();
+    Uci( Uci &other ) = delete;
+
+    // Reads and executes commands until quit or the end of the input
+    void loop();
+    // Executes a single command, returns false on quit
+    bool execute( const std::string &command );
+    // Blocks until the running search sends bestmove, go infinite and go ponder searches have to be stopped first
+    void waitForSearch();
+
+private:
+    std::istream &in_;
+    std::ostream &out_;
+    std::mutex outputMutex_;
+
+    Board board_;
+    PieceValidMoves generator_;
+    Search search_;
+    int threads_ = 1;  // Applied to the search when the next search starts
+    int multiPv_ = 1;
+    std::atomic<bool> debug_ = false;  // Search statistics are sent after every search
+    std::thread searchThread_;
+    std::atomic<bool> stop_;
+
+    void position( std::istringstream &command );
+    void go( std::istringstream &command );
+    void setOption( std::istringstream &command );
+    void stopSearch();
+
+    void send( const std::string &message );
+    void sendInfo( const SearchInfo &info, PieceColor sideToMove );
+};
+
+#endif
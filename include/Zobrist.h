@@ -0,0 +1,25 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+#include "Common.h"
+
+/**
+ * Random keys used to hash board positions.
+ * Keys are generated with a fixed seed, so hashes are reproducible between runs.
+ */
+class Zobrist {
+public:
+    Zobrist() = delete;
+
+    static uint64_t pieceKey( PieceColor color, PieceType type, SquareIndex square ) {
+        return pieceKeys_[color][type][square];
+    }
+
+private:
+    static const std::array<std::array<std::array<uint64_t, 64>, 7>, 2> pieceKeys_;
+};
+
+#endif
@@ -14,7 +14,7 @@ int main() {
     // Board b( "r1bqkbnr/ppp2ppp/2np4/4p3/2B1P3/5Q2/PPPP1PPP/RNB1K1NR w KQkq - 0 2" );
     // PieceValidMoves g;
     // g.generateValidMoves( b );
-    // s.getBestMove( b, 2, b.sideToMove == WHITE );
+    // s.getBestMove( b, 2 );
 
     Board board = Board();
     WindowGui wgui = WindowGui( board );
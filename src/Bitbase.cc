@@ -0,0 +1,319 @@
+#include "Bitbase.h"
+
+#include <bit>
+
+#include "Endgame.h"
+#include "Material.h"
+#include "PieceMoves.h"
+
+// Piece of the strong side indexed by BitbaseEnding
+static const PieceType ENDING_PIECES[3] = { PAWN, ROOK, QUEEN };
+
+// Index of the first square on each rank of the a1-d1-d4 triangle
+static const int TRIANGLE_OFFSETS[4] = { 0, 4, 7, 9 };
+
+// Mirrors the square along the a1-h8 diagonal
+static SquareIndex transpose( SquareIndex square ) { return ( 7 - square % 8 ) * 8 + ( 7 - square / 8 ); }
+
+/* ------------------------------ Constructors ------------------------------ */
+
+Bitbase::Bitbase() {
+    // Pawn promotions are looked up in the KQK and KRK bitbases
+    generate( KQK );
+    generate( KRK );
+    generate( KPK );
+}
+
+/* --------------------------------- Probing -------------------------------- */
+
+/**
+ * Looks up the board in the bitbases.
+ *
+ * @param board position to examine.
+ * @param win set to true if the side with the piece wins, false if the position is a draw.
+ *
+ * @return true if the board is covered by the bitbases.
+ */
+bool Bitbase::probe( const Board &board, bool &win ) {
+    PieceColor strongSide = WHITE;
+    PieceType type = EMPTY;
+
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        for ( PieceType pieceType : { PAWN, KNIGHT, BISHOP, ROOK, QUEEN } ) {
+            const int count = MaterialTable::pieceCount( board.materialKey, color, pieceType );
+            if ( count == 0 ) {
+                continue;
+            }
+            if ( type != EMPTY || count > 1 ) {
+                return false;
+            }
+            type = pieceType;
+            strongSide = color;
+        }
+    }
+
+    BitbaseEnding ending;
+    switch ( type ) {
+        case PAWN:
+            ending = KPK;
+            break;
+        case ROOK:
+            ending = KRK;
+            break;
+        case QUEEN:
+            ending = KQK;
+            break;
+        default:
+            return false;
+    }
+
+    const PieceColor weakSide = strongSide == WHITE ? BLACK : WHITE;
+    if ( board.kingSquares[WHITE] == NULL_SQUARE || board.kingSquares[BLACK] == NULL_SQUARE ) {
+        return false;
+    }
+
+    SquareIndex piece = NULL_SQUARE;
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        if ( board.squares[square] != std::nullopt && board.squares[square]->type == type ) {
+            piece = square;
+            break;
+        }
+    }
+
+    // Flip the board vertically if black has the piece
+    const SquareIndex flip = strongSide == WHITE ? 0 : 56;
+    const PieceColor sideToMove = board.sideToMove == strongSide ? WHITE : BLACK;
+    win = getInstance().isWin( ending, sideToMove, board.kingSquares[strongSide] ^ flip,
+                               board.kingSquares[weakSide] ^ flip, piece ^ flip );
+    return true;
+}
+
+// Position has to be normalized so that white has the piece
+bool Bitbase::isWin( BitbaseEnding ending, PieceColor sideToMove, SquareIndex whiteKing, SquareIndex blackKing,
+                     SquareIndex piece ) const {
+    const std::size_t bit = index( ending, sideToMove, whiteKing, blackKing, piece );
+    return ( wins_[ending][bit / 64] >> ( bit % 64 ) ) & 1;
+}
+
+/* --------------------------------- Helpers -------------------------------- */
+
+std::size_t Bitbase::size( BitbaseEnding ending ) {
+    // Pawn on files a-d and ranks 2-7, or white king in the a1-d1-d4 triangle
+    return ending == KPK ? 2 * 64 * 64 * 24 : 2 * 10 * 64 * 64;
+}
+
+std::size_t Bitbase::index( BitbaseEnding ending, PieceColor sideToMove, SquareIndex whiteKing, SquareIndex blackKing,
+                            SquareIndex piece ) {
+    if ( ending == KPK ) {
+        if ( piece % 8 > 3 ) {
+            whiteKing ^= 7;
+            blackKing ^= 7;
+            piece ^= 7;
+        }
+        const int pawn = ( piece / 8 - 1 ) * 4 + piece % 8;
+        return ( ( sideToMove * 64 + whiteKing ) * 64 + blackKing ) * 24 + pawn;
+    }
+
+    if ( whiteKing % 8 > 3 ) {
+        whiteKing ^= 7;
+        blackKing ^= 7;
+        piece ^= 7;
+    }
+    if ( whiteKing / 8 < 4 ) {
+        whiteKing ^= 56;
+        blackKing ^= 56;
+        piece ^= 56;
+    }
+    if ( 7 - whiteKing / 8 > whiteKing % 8 ) {
+        whiteKing = transpose( whiteKing );
+        blackKing = transpose( blackKing );
+        piece = transpose( piece );
+    }
+    const int rank = 7 - whiteKing / 8;
+    const int triangle = TRIANGLE_OFFSETS[rank] + whiteKing % 8 - rank;
+    return ( ( sideToMove * 10 + triangle ) * 64 + blackKing ) * 64 + piece;
+}
+
+// Squares attacked by a white piece, sliding pieces are blocked by the occupied squares
+Bitboard Bitbase::attacks( PieceType type, SquareIndex square, Bitboard occupied ) {
+    Bitboard attacked = 0;
+
+    for ( const auto &ray : PieceMoves::getInstance().getMoveList( WHITE, type, square ) ) {
+        for ( SquareIndex target : ray ) {
+            // Pawn pushes do not attack, king rays also contain castling moves
+            if ( type == PAWN && target % 8 == square % 8 ) {
+                break;
+            }
+            attacked |= 1ULL << target;
+            if ( type == KING || ( occupied & ( 1ULL << target ) ) ) {
+                break;
+            }
+        }
+    }
+    return attacked;
+}
+
+/* ------------------------------- Generation ------------------------------- */
+
+/**
+ * Generates the bitbase by iterating over all positions until no more wins or draws can be proven.
+ * Position is won if white can move to a won position or black has only moves to won positions.
+ * Positions not resolved after the last iteration are draws.
+ *
+ * @param ending ending to generate.
+ */
+void Bitbase::generate( BitbaseEnding ending ) {
+    const PieceType type = ENDING_PIECES[ending];
+    std::vector<Result> results( size( ending ), INVALID );
+
+    struct Position {
+        std::size_t index;
+        PieceColor sideToMove;
+        SquareIndex whiteKing, blackKing, piece;
+    };
+    std::vector<Position> unknown;
+
+    // Collect legal positions in the normalized form
+    for ( PieceColor sideToMove : { WHITE, BLACK } ) {
+        for ( SquareIndex whiteKing = 0; whiteKing < 64; whiteKing++ ) {
+            const int file = whiteKing % 8;
+            const int rank = 7 - whiteKing / 8;
+            if ( ending != KPK && ( file > 3 || rank > file ) ) {
+                continue;
+            }
+            for ( SquareIndex blackKing = 0; blackKing < 64; blackKing++ ) {
+                for ( SquareIndex piece = 0; piece < 64; piece++ ) {
+                    if ( ending == KPK && ( piece % 8 > 3 || piece < 8 || piece > 55 ) ) {
+                        continue;
+                    }
+                    if ( piece == whiteKing || piece == blackKing || Endgame::distance( whiteKing, blackKing ) <= 1 ) {
+                        continue;
+                    }
+                    // Side not to move cannot be in check
+                    const Bitboard occupied = ( 1ULL << whiteKing ) | ( 1ULL << blackKing );
+                    if ( sideToMove == WHITE && ( attacks( type, piece, occupied ) & ( 1ULL << blackKing ) ) ) {
+                        continue;
+                    }
+
+                    const std::size_t bit = index( ending, sideToMove, whiteKing, blackKing, piece );
+                    results[bit] = UNKNOWN;
+                    unknown.push_back( { bit, sideToMove, whiteKing, blackKing, piece } );
+                }
+            }
+        }
+    }
+
+    // Every iteration resolves positions one ply further from the mate or the draw
+    bool changed = true;
+    while ( changed ) {
+        changed = false;
+        std::size_t remaining = 0;
+        for ( const Position &position : unknown ) {
+            const Result result = classify( ending, results, position.sideToMove, position.whiteKing,
+                                            position.blackKing, position.piece );
+            if ( result != UNKNOWN ) {
+                results[position.index] = result;
+                changed = true;
+            } else {
+                unknown[remaining++] = position;
+            }
+        }
+        unknown.resize( remaining );
+    }
+
+    wins_[ending].assign( ( results.size() + 63 ) / 64, 0 );
+    for ( std::size_t bit = 0; bit < results.size(); bit++ ) {
+        if ( results[bit] == WIN ) {
+            wins_[ending][bit / 64] |= 1ULL << ( bit % 64 );
+        }
+    }
+}
+
+/**
+ * Classifies the position by the results of its successors.
+ *
+ * @return WIN or DRAW if the result is already known, UNKNOWN otherwise.
+ */
+Bitbase::Result Bitbase::classify( BitbaseEnding ending, const std::vector<Result> &results, PieceColor sideToMove,
+                                   SquareIndex whiteKing, SquareIndex blackKing, SquareIndex piece ) const {
+    const PieceType type = ENDING_PIECES[ending];
+    const PieceMoves &pieceMoves = PieceMoves::getInstance();
+    bool unresolved = false;
+
+    /* ---------------------------------- White --------------------------------- */
+    if ( sideToMove == WHITE ) {
+        const Bitboard occupied = ( 1ULL << whiteKing ) | ( 1ULL << blackKing ) | ( 1ULL << piece );
+        auto visit = [&]( Result result ) {
+            unresolved |= result == UNKNOWN;
+            return result == WIN;
+        };
+
+        for ( const auto &ray : pieceMoves.getMoveList( WHITE, KING, whiteKing ) ) {
+            const SquareIndex target = ray.front();
+            if ( target == piece || Endgame::distance( target, blackKing ) <= 1 ) {
+                continue;
+            }
+            if ( visit( results[index( ending, BLACK, target, blackKing, piece )] ) ) {
+                return WIN;
+            }
+        }
+
+        if ( type == PAWN ) {
+            for ( const auto &ray : pieceMoves.getMoveList( WHITE, PAWN, piece ) ) {
+                for ( SquareIndex target : ray ) {
+                    if ( target % 8 != piece % 8 || ( occupied & ( 1ULL << target ) ) ) {
+                        break;
+                    }
+                    // Promotion to a rook avoids some stalemates
+                    const Result result = target >= 8 ? results[index( KPK, BLACK, whiteKing, blackKing, target )]
+                                          : isWin( KQK, BLACK, whiteKing, blackKing, target ) ||
+                                                  isWin( KRK, BLACK, whiteKing, blackKing, target )
+                                              ? WIN
+                                              : DRAW;
+                    if ( visit( result ) ) {
+                        return WIN;
+                    }
+                }
+            }
+        } else {
+            for ( Bitboard targets = attacks( type, piece, occupied ) & ~occupied; targets; targets &= targets - 1 ) {
+                const SquareIndex target = std::countr_zero( targets );
+                if ( visit( results[index( ending, BLACK, whiteKing, blackKing, target )] ) ) {
+                    return WIN;
+                }
+            }
+        }
+
+        // Stalemate or only drawing moves
+        return unresolved ? UNKNOWN : DRAW;
+    }
+
+    /* ---------------------------------- Black --------------------------------- */
+    // Black king does not block the attacks on the squares behind it
+    const Bitboard attacked = attacks( type, piece, 1ULL << whiteKing ) | attacks( KING, whiteKing, 0 );
+    bool hasMove = false;
+
+    for ( const auto &ray : pieceMoves.getMoveList( BLACK, KING, blackKing ) ) {
+        const SquareIndex target = ray.front();
+        if ( attacked & ( 1ULL << target ) ) {
+            continue;
+        }
+        // Capture of the undefended piece
+        if ( target == piece ) {
+            return DRAW;
+        }
+        hasMove = true;
+        const Result result = results[index( ending, WHITE, whiteKing, target, piece )];
+        if ( result == DRAW ) {
+            return DRAW;
+        }
+        unresolved |= result == UNKNOWN;
+    }
+
+    if ( !hasMove ) {
+        // Checkmate or stalemate
+        const Bitboard occupied = ( 1ULL << whiteKing ) | ( 1ULL << blackKing );
+        return attacks( type, piece, occupied ) & ( 1ULL << blackKing ) ? WIN : DRAW;
+    }
+    return unresolved ? UNKNOWN : WIN;
+}
@@ -10,9 +10,18 @@
 
 #include "Board.h"
 
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <charconv>
 #include <iostream>
 #include <stdexcept>
 
+#include "Evaluation.h"
+#include "Material.h"
+#include "Trace.h"
+#include "Zobrist.h"
+
 
 /* ------------------------------ Constructors ------------------------------ */
 
@@ -25,155 +34,67 @@ Board::Board()
       whiteIsCheckMated( false ),
       blackIsCheckMated( false ),
       staleMate( false ),
-      score( 0 ),
+      score{ 0, 0 },
+      materialKey( 0 ),
+      pawnKey( 0 ),
+      kingSquares{ NULL_SQUARE, NULL_SQUARE },
       sideToMove( WHITE ),
       lastMove( MoveContent() ),
       enPassantSquare( NULL_SQUARE ),
       fiftyMoveCounter_( 0 ),
+      fullMoveNumber_( 1 ),
       threefoldRepetitionCounter_( 0 ) {
     for ( SquareIndex i = 0; i < 64; i++ ) {
         if ( STARTING_POSITION[i] == EMPTY ) {
             continue;
         }
 
-        PieceColor color;
-
-        if ( i < 16 ) {  // Black side squares are low indieces
-            color = BLACK;
-        } else if ( i > 47 ) {  // White side squares are high indieces
-            color = WHITE;
-        }
+        // Black side squares are low indices, white side squares are high indices
+        const PieceColor color = i < 16 ? BLACK : WHITE;
 
         squares[i] = std::make_optional<Piece>( color, STARTING_POSITION[i], false );
     }
+
+    computeIncrementalState();
 }
 
-Board::Board( std::string fen )
+// Throws std::invalid_argument on invalid FEN, use parseFEN to handle errors without exceptions
+Board::Board( std::string_view fen ) : Board() {
+    const FenError error = parseFEN( fen );
+    if ( error != FEN_OK ) {
+        throw std::invalid_argument( std::string( "Invalid FEN notation - " ) + fenErrorMessage( error ) );
+    }
+}
+
+Board::Board( const PackedPosition &position )
     : whiteIsChecked( false ),
       blackIsChecked( false ),
       whiteIsCheckMated( false ),
       blackIsCheckMated( false ),
       staleMate( false ),
-      score( 0 ),
+      lastMove( MoveContent() ),
       threefoldRepetitionCounter_( 0 ) {
-    /* ------------------------ Board squares description ----------------------- */
-    int numOfSlashes = 0;         // Should be exactly 7 slashes
-    SquareIndex squareIndex = 0;  // Should be exactly 64 squares
-    int lastSlashIndex = -1;      // Cant be two consecutive slashes
-    auto it = fen.cbegin();
-    while ( it != fen.cend() && *it != ' ' ) {
-        // Is piece - one of: "pnbrqkPNBRQK"
-        if ( isalpha( *it ) ) {
-            std::string validPieces = "pnbrqkPNBRQK";
-            if ( std::find( validPieces.cbegin(), validPieces.cend(), *it ) == validPieces.cend() ) {
-                throw std::invalid_argument( "Invalid FEN notation - unknown piece char" );
-            }
-            squares[squareIndex++] = Piece( *it );
-        }
-        // Is n empty squares - one of: "12345678"
-        else if ( isdigit( *it ) ) {
-            int numOfEmptySquares = int( *it ) - 48;
-            if ( numOfEmptySquares < 1 || numOfEmptySquares > 8 ) {
-                throw std::invalid_argument( "Invalid FEN notation - invalid number of empty squares" );
-            }
-            for ( int i = 0; i < numOfEmptySquares; i++ ) {
-                squares[squareIndex++] = std::nullopt;
-            }
-        }
-        // Is separator '/'
-        else if ( *it == '/' ) {
-            if ( it - fen.cbegin() - lastSlashIndex == 1 || ++numOfSlashes > 7 ) {
-                throw std::invalid_argument( "Invalid FEN notation - invalid number of slashes" );
-            }
-            lastSlashIndex = it - fen.cbegin();
-        }
-        // Anyhing else is invalid
-        else {
-            throw std::invalid_argument( "Invalid FEN notation - invalid char encountered" );
-        }
-        ++it;
-    }
-
-    if ( squareIndex != 64 || numOfSlashes != 7 ) {
-        throw std::invalid_argument( "Invalid FEN notation - invalid number of squares described or slashes" );
-    }
-
-    /* ------------------------------ side to move ------------------------------ */
-    if ( ++it == fen.cend() ) throw std::invalid_argument( "Invalid FEN notation - side to move required" );
-
-    if ( *it == 'w' ) {
-        sideToMove = WHITE;
-    } else if ( *it == 'b' ) {
-        sideToMove = BLACK;
-    } else {
-        throw std::invalid_argument( "Invalid FEN notation - invalid side to move" );
-    }
-
-    if ( ++it == fen.cend() || *it != ' ' )
-        throw std::invalid_argument( "Invalid FEN notation - castling rights required" );
-
-    /* ----------------------------- Castling rights ---------------------------- */
-    while ( ++it != fen.cend() && *it != ' ' ) {
-        if ( *it == '-' ) {
-            blackHasCastled = true;
-            whiteHasCastled = true;
-            continue;
-        } else if ( *it == 'K' ) {
-            if ( !squares[63] || squares[63]->type != ROOK || squares[63]->color != WHITE ) {
-                throw std::invalid_argument( "Invalid FEN notation - white king side castling requires a rook on H1" );
-            }
-            whiteHasCastled = false;
-        } else if ( *it == 'Q' ) {
-            if ( !squares[56] || squares[56]->type != ROOK || squares[56]->color != WHITE ) {
-                throw std::invalid_argument( "Invalid FEN notation - white queen side castling requires a rook on A1" );
-            }
-            whiteHasCastled = false;
-        } else if ( *it == 'k' ) {
-            if ( !squares[7] || squares[7]->type != ROOK || squares[7]->color != BLACK ) {
-                throw std::invalid_argument( "Invalid FEN notation - black king side castling requires a rook on H8" );
-            }
-            blackHasCastled = false;
-        } else if ( *it == 'q' ) {
-            if ( !squares[0] || squares[0]->type != ROOK || squares[0]->color != BLACK ) {
-                throw std::invalid_argument( "Invalid FEN notation - black king side castling requires a rook on A8" );
-            }
-            blackHasCastled = false;
-        } else {
-            throw std::invalid_argument( "Invalid FEN notation - invalid castling rights" );
-        }
-    }
-
-    /* ------------------------------- En passant ------------------------------- */
-    if ( ++it == fen.cend() ) throw std::invalid_argument( "Invalid FEN notation - en passant required" );
-
-    if ( *it == '-' ) {
-        ++it;
-    } else {
-        char file = tolower( *it );
-        if ( ++it == fen.cend() ) throw std::invalid_argument( "Invalid FEN notation - en passant square description" );
-        char rank = *it;
-        if ( file < 'a' || file > 'h' || rank < '1' || rank > '8' ) {
-            throw std::invalid_argument( "Invalid FEN notation - en passant square description" );
+    int piece = 0;
+    for ( Bitboard occupancy = position.occupancy; occupancy != 0; occupancy &= occupancy - 1, piece++ ) {
+        const int code = position.pieces[piece / 2] >> ( piece % 2 * 4 ) & 0xF;
+        const PieceType type = PieceType( code & 7 );
+        if ( type == EMPTY || type > PAWN || piece == 32 ) {
+            throw std::invalid_argument( "Invalid packed position - unknown piece code" );
         }
-        enPassantSquare = 8 * ( 8 - ( int( rank ) - 48 ) ) + ( int( file ) - 97 );
+        squares[std::countr_zero( occupancy )] = Piece( PieceColor( code >> 3 ), type );
     }
 
-    if ( it == fen.cend() || *it != ' ' )
-        throw std::invalid_argument( "Invalid FEN notation - fifty move count required" );
-
-    /* --------------------------- fifty move counter --------------------------- */
-    std::string fiftyMoveCount;
-    while ( ++it != fen.cend() && *it != ' ' ) {
-        fiftyMoveCount += *it;
+    bool rights[4];
+    for ( int right = 0; right < 4; right++ ) {
+        rights[right] = position.flags >> ( right + 1 ) & 1;
     }
-    fiftyMoveCounter_ = std::stoi( fiftyMoveCount );
-    if ( it == fen.cend() ) throw std::invalid_argument( "Invalid FEN notation - turn count required" );
+    setCastlingRights( rights );
 
-    /* ------------------------------- turn count ------------------------------- */
-    std::string turnCount;
-    while ( ++it != fen.cend() ) {
-        turnCount += *it;
-    }
+    sideToMove = PieceColor( position.flags & 1 );
+    enPassantSquare = position.enPassantSquare;
+    fiftyMoveCounter_ = position.halfMoveClock;
+    fullMoveNumber_ = position.fullMoveNumber;
+    computeIncrementalState();
 }
 
 Board Board::fastCopy() const {
@@ -182,8 +103,13 @@ Board Board::fastCopy() const {
     copy.whiteHasCastled = this->whiteHasCastled;
     copy.blackHasCastled = this->blackHasCastled;
     copy.fiftyMoveCounter_ = this->fiftyMoveCounter_;
+    copy.fullMoveNumber_ = this->fullMoveNumber_;
     copy.lastMove = this->lastMove;
     copy.threefoldRepetitionCounter_ = this->threefoldRepetitionCounter_;
+    copy.score = this->score;
+    copy.materialKey = this->materialKey;
+    copy.pawnKey = this->pawnKey;
+    copy.kingSquares = this->kingSquares;
     for ( int i = 0; i < 64; i++ ) {
         if ( this->squares[i] != std::nullopt ) {
             auto piece = Piece( this->squares[i]->color, this->squares[i]->type, this->squares[i]->hasMoved );
@@ -196,6 +122,15 @@ Board Board::fastCopy() const {
 /* --------------------------------- Methods -------------------------------- */
 
 void Board::makeMove( SquareIndex src, SquareIndex dest, PieceType promotion ) {
+    sideToMove == WHITE ? makeMove<WHITE>( src, dest, promotion ) : makeMove<BLACK>( src, dest, promotion );
+}
+
+// Pawn directions, promotion ranks and castling squares of the side to move are known at compile time
+template <PieceColor Us>
+void Board::makeMove( SquareIndex src, SquareIndex dest, PieceType promotion ) {
+    TRACE_SCOPE( "Board::makeMove" );
+    assert( sideToMove == Us );
+    constexpr PieceColor Them = Us == WHITE ? BLACK : WHITE;
     validateMove( src, dest, promotion );
 
     PieceType pieceMoving = squares[src] ? squares[src]->type : EMPTY;
@@ -209,21 +144,28 @@ void Board::makeMove( SquareIndex src, SquareIndex dest, PieceType promotion ) {
     lastMove.promotion = promotion;
     lastMove.isEnPassantCapture = false;
 
+    // Update the score of the moving and the captured piece (promoted piece is scored on the dest square)
+    removePieceScore( Us, pieceMoving, src );
+    addPieceScore( Us, promotion == EMPTY ? pieceMoving : promotion, dest );
+    if ( pieceTaken != EMPTY ) {
+        removePieceScore( Them, pieceTaken, dest );
+    }
+
     // Detect special move scenario and handle extra behaviour
     // Pawn move by 2
     if ( pieceMoving == PAWN && abs( src - dest ) == 16 ) {
-        recordEnPassant( src, dest );
+        recordEnPassant<Us>( dest );
     }
     // En passant capture
     else if ( enPassantIsAvailable() && pieceMoving == PAWN && dest == enPassantSquare ) {
-        handleEnPassant();
+        handleEnPassant<Us>();
     }
     // Castling
     else if ( pieceMoving == KING && abs( src - dest ) == 2 ) {
-        handleCastling( src, dest );
+        handleCastling<Us>( src, dest );
     }
     // Pawn promotion
-    else if ( pieceMoving == PAWN && ( dest < 8 || dest > 55 ) ) {
+    else if ( pieceMoving == PAWN && ( Us == WHITE ? dest < 8 : dest > 55 ) ) {
         handlePromotion( src, promotion );
     }
 
@@ -233,17 +175,20 @@ void Board::makeMove( SquareIndex src, SquareIndex dest, PieceType promotion ) {
     squares[dest]->hasMoved = true;
 
     // Update side to move
-    sideToMove = sideToMove == WHITE ? BLACK : WHITE;
+    if ( Us == BLACK ) {
+        fullMoveNumber_++;
+    }
+    sideToMove = Them;
 
     // Clear enPassantSquare
     if ( pieceMoving != PAWN || abs( src - dest ) != 16 ) {
         enPassantSquare = NULL_SQUARE;
     }
 
-    // Update 50 repetition counter
+    // Update 50 move counter, it counts the plies of both sides
     if ( pieceMoving != PAWN && pieceTaken == EMPTY ) {
         fiftyMoveCounter_++;
-        if ( fiftyMoveCounter_ == 50 ) {
+        if ( fiftyMoveCounter_ >= 100 ) {
             staleMate = true;
             return;
         }
@@ -254,6 +199,9 @@ void Board::makeMove( SquareIndex src, SquareIndex dest, PieceType promotion ) {
     // TODO: Update threefoldRepetitionCounter
 }
 
+template void Board::makeMove<WHITE>( SquareIndex src, SquareIndex dest, PieceType promotion );
+template void Board::makeMove<BLACK>( SquareIndex src, SquareIndex dest, PieceType promotion );
+
 // TODO: separate conversion of the move representation
 // D2D4 notation (D2D4Q for promotion)
 void Board::makeMove( std::string move ) {
@@ -301,6 +249,267 @@ void Board::makeMove( std::string move ) {
     }
 }
 
+/* ------------------------------ Serialization ----------------------------- */
+
+// Castling rights in the FEN order: K, Q, k, q
+static const char CASTLING_RIGHTS[4] = { 'K', 'Q', 'k', 'q' };
+static const SquareIndex CASTLING_KING_SQUARES[4] = { 60, 60, 4, 4 };
+static const SquareIndex CASTLING_ROOK_SQUARES[4] = { 63, 56, 7, 0 };
+
+// FEN piece letters indexed by PieceType
+static const char PIECE_LETTERS[2][7] = { { ' ', 'R', 'N', 'B', 'Q', 'K', 'P' },
+                                         { ' ', 'r', 'n', 'b', 'q', 'k', 'p' } };
+
+const char *fenErrorMessage( FenError error ) {
+    switch ( error ) {
+        case FEN_OK:
+            return "no error";
+        case FEN_INVALID_PIECE_PLACEMENT:
+            return "invalid piece placement";
+        case FEN_INVALID_SIDE_TO_MOVE:
+            return "invalid side to move";
+        case FEN_INVALID_CASTLING_RIGHTS:
+            return "invalid castling rights";
+        case FEN_INVALID_EN_PASSANT:
+            return "invalid en passant square";
+        case FEN_INVALID_HALF_MOVE_CLOCK:
+            return "invalid half move clock";
+        case FEN_INVALID_FULL_MOVE_NUMBER:
+            return "invalid full move number";
+    }
+    return "unknown error";
+}
+
+/**
+ * Sets up the position described by the FEN, the fields are read in place from the view.
+ * Castling rights are kept by the hasMoved flags, so kings and rooks without the right are marked as moved.
+ *
+ * @param fen six space separated fields, for example: rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1
+ *
+ * @return FEN_OK or the error of the first invalid field.
+ */
+FenError Board::parseFEN( std::string_view fen ) {
+    std::size_t pos = 0;
+    auto nextField = [&]() {
+        while ( pos < fen.size() && fen[pos] == ' ' ) {
+            pos++;
+        }
+        const std::size_t end = std::min( fen.find( ' ', pos ), fen.size() );
+        const std::string_view field = fen.substr( pos, end - pos );
+        pos = end;
+        return field;
+    };
+    auto parseNumber = []( std::string_view field, int &value ) {
+        const auto [end, error] = std::from_chars( field.data(), field.data() + field.size(), value );
+        return error == std::errc() && end == field.data() + field.size() && value >= 0;
+    };
+
+    /* -------------------------------- Placement ------------------------------- */
+    squares.fill( std::nullopt );
+    SquareIndex square = 0;
+    int file = 0;
+    for ( char c : nextField() ) {
+        if ( c == '/' ) {
+            if ( file != 8 || square == 64 ) {
+                return FEN_INVALID_PIECE_PLACEMENT;
+            }
+            file = 0;
+        } else if ( c >= '1' && c <= '8' ) {
+            file += c - '0';
+            square += c - '0';
+            if ( file > 8 ) {
+                return FEN_INVALID_PIECE_PLACEMENT;
+            }
+        } else {
+            if ( file == 8 || std::string_view( "pnbrqkPNBRQK" ).find( c ) == std::string_view::npos ) {
+                return FEN_INVALID_PIECE_PLACEMENT;
+            }
+            squares[square++] = Piece( c );
+            file++;
+        }
+    }
+    if ( square != 64 || file != 8 ) {
+        return FEN_INVALID_PIECE_PLACEMENT;
+    }
+
+    /* ------------------------------ Side to move ------------------------------ */
+    const std::string_view side = nextField();
+    if ( side == "w" ) {
+        sideToMove = WHITE;
+    } else if ( side == "b" ) {
+        sideToMove = BLACK;
+    } else {
+        return FEN_INVALID_SIDE_TO_MOVE;
+    }
+
+    /* ----------------------------- Castling rights ---------------------------- */
+    const std::string_view castling = nextField();
+    bool rights[4] = { false, false, false, false };
+    if ( castling != "-" ) {
+        if ( castling.empty() ) {
+            return FEN_INVALID_CASTLING_RIGHTS;
+        }
+        for ( char c : castling ) {
+            const int right = std::find( CASTLING_RIGHTS, CASTLING_RIGHTS + 4, c ) - CASTLING_RIGHTS;
+            if ( right == 4 ) {
+                return FEN_INVALID_CASTLING_RIGHTS;
+            }
+            const PieceColor color = right < 2 ? WHITE : BLACK;
+            const auto &king = squares[CASTLING_KING_SQUARES[right]];
+            const auto &rook = squares[CASTLING_ROOK_SQUARES[right]];
+            if ( !king || king->type != KING || king->color != color || !rook || rook->type != ROOK ||
+                 rook->color != color ) {
+                return FEN_INVALID_CASTLING_RIGHTS;
+            }
+            rights[right] = true;
+        }
+    }
+    setCastlingRights( rights );
+
+    /* ------------------------------- En passant ------------------------------- */
+    const std::string_view enPassant = nextField();
+    if ( enPassant == "-" ) {
+        enPassantSquare = NULL_SQUARE;
+    } else if ( enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' &&
+                ( enPassant[1] == '3' || enPassant[1] == '6' ) ) {
+        enPassantSquare = ( '8' - enPassant[1] ) * 8 + enPassant[0] - 'a';
+    } else {
+        return FEN_INVALID_EN_PASSANT;
+    }
+
+    /* ------------------------------ Move counters ----------------------------- */
+    if ( !parseNumber( nextField(), fiftyMoveCounter_ ) ) {
+        return FEN_INVALID_HALF_MOVE_CLOCK;
+    }
+    if ( !parseNumber( nextField(), fullMoveNumber_ ) || !nextField().empty() ) {
+        return FEN_INVALID_FULL_MOVE_NUMBER;
+    }
+
+    whiteIsChecked = blackIsChecked = false;
+    whiteIsCheckMated = blackIsCheckMated = staleMate = false;
+    lastMove = MoveContent();
+    threefoldRepetitionCounter_ = 0;
+    computeIncrementalState();
+    return FEN_OK;
+}
+
+/**
+ * Writes the position in FEN notation, castling rights are derived the same way the move generator checks them.
+ *
+ * @param out buffer of at least FEN_BUFFER_SIZE chars.
+ *
+ * @return pointer to the terminating null written after the FEN.
+ */
+char *Board::toFEN( char *out ) const {
+    for ( int row = 0; row < 8; row++ ) {
+        int emptySquares = 0;
+        for ( int file = 0; file < 8; file++ ) {
+            const auto &piece = squares[row * 8 + file];
+            if ( !piece ) {
+                emptySquares++;
+                continue;
+            }
+            if ( emptySquares > 0 ) {
+                *out++ = '0' + emptySquares;
+                emptySquares = 0;
+            }
+            *out++ = PIECE_LETTERS[piece->color][piece->type];
+        }
+        if ( emptySquares > 0 ) {
+            *out++ = '0' + emptySquares;
+        }
+        *out++ = row < 7 ? '/' : ' ';
+    }
+
+    *out++ = sideToMove == WHITE ? 'w' : 'b';
+    *out++ = ' ';
+
+    const char *castlingStart = out;
+    for ( int right = 0; right < 4; right++ ) {
+        if ( hasCastlingRight( right ) ) {
+            *out++ = CASTLING_RIGHTS[right];
+        }
+    }
+    if ( out == castlingStart ) {
+        *out++ = '-';
+    }
+    *out++ = ' ';
+
+    if ( enPassantSquare == NULL_SQUARE ) {
+        *out++ = '-';
+    } else {
+        *out++ = 'a' + enPassantSquare % 8;
+        *out++ = '8' - enPassantSquare / 8;
+    }
+    *out++ = ' ';
+
+    out = std::to_chars( out, out + 11, fiftyMoveCounter_ ).ptr;
+    *out++ = ' ';
+    out = std::to_chars( out, out + 11, fullMoveNumber_ ).ptr;
+    *out = '\0';
+    return out;
+}
+
+std::string Board::toFEN() const {
+    char buffer[FEN_BUFFER_SIZE];
+    return std::string( buffer, toFEN( buffer ) );
+}
+
+PackedPosition Board::pack( int score, int result ) const {
+    PackedPosition position = {};
+    int piece = 0;
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        if ( !squares[square] ) {
+            continue;
+        }
+        if ( piece == 32 ) {
+            throw std::invalid_argument( "Cannot pack a position with more than 32 pieces" );
+        }
+        position.occupancy |= 1ULL << square;
+        position.pieces[piece / 2] |= ( squares[square]->color << 3 | squares[square]->type ) << ( piece % 2 * 4 );
+        piece++;
+    }
+
+    position.flags = sideToMove;
+    for ( int right = 0; right < 4; right++ ) {
+        position.flags |= hasCastlingRight( right ) << ( right + 1 );
+    }
+    position.enPassantSquare = enPassantSquare;
+    position.halfMoveClock = std::min( fiftyMoveCounter_, 255 );
+    position.fullMoveNumber = std::min( fullMoveNumber_, 65535 );
+    position.score = std::clamp<int>( score, PackedPosition::NO_SCORE, INT16_MAX );
+    position.result = result;
+    return position;
+}
+
+/* ----------------------------- Castling rights ---------------------------- */
+
+// Castling rights are kept by the hasMoved flags of kings and rooks, which the move generator checks
+bool Board::hasCastlingRight( int right ) const {
+    const PieceColor color = right < 2 ? WHITE : BLACK;
+    const auto &king = squares[CASTLING_KING_SQUARES[right]];
+    const auto &rook = squares[CASTLING_ROOK_SQUARES[right]];
+    const bool hasCastled = color == WHITE ? whiteHasCastled : blackHasCastled;
+    return !hasCastled && king && king->type == KING && king->color == color && !king->hasMoved && rook &&
+           rook->type == ROOK && rook->color == color && !rook->hasMoved;
+}
+
+// Marks kings and rooks without the castling right as moved, rights are in the FEN order
+void Board::setCastlingRights( const bool rights[4] ) {
+    whiteHasCastled = !rights[0] && !rights[1];
+    blackHasCastled = !rights[2] && !rights[3];
+    for ( int right = 0; right < 4; right++ ) {
+        auto &king = squares[CASTLING_KING_SQUARES[right]];
+        auto &rook = squares[CASTLING_ROOK_SQUARES[right]];
+        if ( king && king->type == KING && !rights[right & ~1] && !rights[right | 1] ) {
+            king->hasMoved = true;
+        }
+        if ( rook && rook->type == ROOK && !rights[right] ) {
+            rook->hasMoved = true;
+        }
+    }
+}
+
 /* ------------------------- makeMove helper methods ------------------------ */
 
 // Returns true if enPassant is available
@@ -349,59 +558,41 @@ void Board::validateMove( SquareIndex src, SquareIndex dest, PieceType promotion
 }
 
 // Sets en passant square according to destination square
-void Board::recordEnPassant( SquareIndex src, SquareIndex dest ) {
-    if ( squares[src]->color == WHITE ) {
-        enPassantSquare = dest + 8;
-    } else if ( squares[src]->color == BLACK ) {
-        enPassantSquare = dest - 8;
-    }
+// Square behind the pawn, white pawns move towards the lower squares
+template <PieceColor Us>
+void Board::recordEnPassant( SquareIndex dest ) {
+    enPassantSquare = Us == WHITE ? dest + 8 : dest - 8;
 }
 
 // Clears enPassant square and records additional lastMove details
+template <PieceColor Us>
 void Board::handleEnPassant() {
-    if ( sideToMove == WHITE ) {
-        squares[enPassantSquare + 8] = std::nullopt;
-    } else if ( sideToMove == BLACK ) {
-        squares[enPassantSquare - 8] = std::nullopt;
-    }
+    constexpr PieceColor Them = Us == WHITE ? BLACK : WHITE;
+    const SquareIndex captured = Us == WHITE ? enPassantSquare + 8 : enPassantSquare - 8;
+    squares[captured] = std::nullopt;
+    removePieceScore( Them, PAWN, captured );
     lastMove.isEnPassantCapture = true;
     lastMove.pieceTaken = PAWN;
 }
 
 // Moves the rook according to the castling move being made
+// Rook jumps over the king, castling squares of the side are compile time constants
+template <PieceColor Us>
 void Board::handleCastling( SquareIndex src, SquareIndex dest ) {
-    // white castle
-    if ( src == 60 ) {
-        // king side
-        if ( dest == 62 ) {
-            squares[61] = std::move( squares[63] );
-            squares[61]->hasMoved = true;
-            squares[63] = std::nullopt;
-        }
-        // queen side
-        if ( dest == 58 ) {
-            squares[59] = std::move( squares[56] );
-            squares[59]->hasMoved = true;
-            squares[56] = std::nullopt;
-        }
-        whiteHasCastled = true;
-    }
-    // black castle
-    else if ( src == 4 ) {
-        // king side
-        if ( dest == 6 ) {
-            squares[5] = std::move( squares[7] );
-            squares[5]->hasMoved = true;
-            squares[7] = std::nullopt;
-        }
-        // queen side
-        else if ( dest == 2 ) {
-            squares[3] = std::move( squares[0] );
-            squares[3]->hasMoved = true;
-            squares[0] = std::nullopt;
-        }
-        blackHasCastled = true;
+    constexpr SquareIndex kingSquare = Us == WHITE ? 60 : 4;
+    if ( src != kingSquare ) {
+        return;
     }
+    const bool isKingSide = dest == kingSquare + 2;
+    const SquareIndex rookSrc = isKingSide ? kingSquare + 3 : kingSquare - 4;
+    const SquareIndex rookDest = isKingSide ? kingSquare + 1 : kingSquare - 1;
+
+    squares[rookDest] = std::move( squares[rookSrc] );
+    squares[rookDest]->hasMoved = true;
+    squares[rookSrc] = std::nullopt;
+    removePieceScore( Us, ROOK, rookSrc );
+    addPieceScore( Us, ROOK, rookDest );
+    ( Us == WHITE ? whiteHasCastled : blackHasCastled ) = true;
 }
 
 // Changes type of promoted piece, while its still on the src square
@@ -410,3 +601,35 @@ void Board::handlePromotion( SquareIndex src, PieceType promotion ) {
     squares[src]->value = Piece::calculatePieceValue( promotion );
     squares[src]->actionValue = Piece::calculatePieceActionValue( promotion );
 }
+
+/* --------------------- Incremental evaluation helpers --------------------- */
+
+// Computes the state updated incrementally by makeMove from scratch
+void Board::computeIncrementalState() {
+    score = { Evaluation::computeScore( *this, MIDDLE_GAME ), Evaluation::computeScore( *this, END_GAME ) };
+    materialKey = Evaluation::computeMaterialKey( *this );
+    pawnKey = Evaluation::computePawnKey( *this );
+    kingSquares = Evaluation::findKingSquares( *this );
+}
+
+// Adds material, piece square scores, material key and pawn key of a piece placed on the square
+void Board::addPieceScore( PieceColor color, PieceType type, SquareIndex square ) {
+    score[MIDDLE_GAME] += Evaluation::pieceSquareScore( MIDDLE_GAME, color, type, square );
+    score[END_GAME] += Evaluation::pieceSquareScore( END_GAME, color, type, square );
+    materialKey += MaterialTable::materialKeyUnit( color, type );
+    if ( type == PAWN ) {
+        pawnKey ^= Zobrist::pieceKey( color, PAWN, square );
+    } else if ( type == KING ) {
+        kingSquares[color] = square;
+    }
+}
+
+// Removes material, piece square scores, material key and pawn key of a piece leaving the square
+void Board::removePieceScore( PieceColor color, PieceType type, SquareIndex square ) {
+    score[MIDDLE_GAME] -= Evaluation::pieceSquareScore( MIDDLE_GAME, color, type, square );
+    score[END_GAME] -= Evaluation::pieceSquareScore( END_GAME, color, type, square );
+    materialKey -= MaterialTable::materialKeyUnit( color, type );
+    if ( type == PAWN ) {
+        pawnKey ^= Zobrist::pieceKey( color, PAWN, square );
+    }
+}
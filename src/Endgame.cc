@@ -0,0 +1,113 @@
+#include "Endgame.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Bitbase.h"
+
+/* --------------------------------- Helpers -------------------------------- */
+
+// Number of king moves between the squares
+int Endgame::distance( SquareIndex a, SquareIndex b ) {
+    return std::max( std::abs( a % 8 - b % 8 ), std::abs( a / 8 - b / 8 ) );
+}
+
+int Endgame::distanceToEdge( SquareIndex square ) {
+    const int file = square % 8;
+    const int row = square / 8;
+    return std::min( { file, 7 - file, row, 7 - row } );
+}
+
+/* -------------------------------- Endgames -------------------------------- */
+
+/**
+ * Evaluates king with major pieces against a bare king.
+ * Rewards pushing the losing king to the edge and bringing the winning king closer.
+ *
+ * @param board position to examine.
+ * @param strongSide side with the major pieces.
+ *
+ * @return int score for the board, positive for white.
+ */
+int Endgame::evaluateKXK( const Board &board, PieceColor strongSide ) {
+    const SquareIndex strongKing = board.kingSquares[strongSide];
+    const SquareIndex weakKing = board.kingSquares[strongSide == WHITE ? BLACK : WHITE];
+    if ( strongKing == NULL_SQUARE || weakKing == NULL_SQUARE ) {
+        return board.score[END_GAME];
+    }
+
+    const int sign = strongSide == WHITE ? 1 : -1;
+    const int bonus = KNOWN_WIN_BONUS + PUSH_TO_EDGE_BONUS * ( 3 - distanceToEdge( weakKing ) ) +
+                      PUSH_CLOSE_BONUS * ( 7 - distance( strongKing, weakKing ) );
+
+    return board.score[END_GAME] + sign * bonus;
+}
+
+/**
+ * Evaluates king, bishop and knight against a bare king.
+ * Mate can only be forced in the corner of the bishop's square color, so the losing king is driven there.
+ *
+ * @param board position to examine.
+ * @param strongSide side with the bishop and knight.
+ *
+ * @return int score for the board, positive for white.
+ */
+int Endgame::evaluateKBNK( const Board &board, PieceColor strongSide ) {
+    const SquareIndex strongKing = board.kingSquares[strongSide];
+    const SquareIndex weakKing = board.kingSquares[strongSide == WHITE ? BLACK : WHITE];
+    if ( strongKing == NULL_SQUARE || weakKing == NULL_SQUARE ) {
+        return board.score[END_GAME];
+    }
+
+    SquareIndex bishop = NULL_SQUARE;
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        const auto &piece = board.squares[square];
+        if ( piece != std::nullopt && piece->type == BISHOP ) {
+            bishop = square;
+        }
+    }
+
+    // a8 and h1 are light squares, h8 and a1 are dark squares
+    const bool lightBishop = ( bishop % 8 + bishop / 8 ) % 2 == 0;
+    const int cornerDistance =
+        lightBishop ? std::min( distance( weakKing, 0 ), distance( weakKing, 63 ) )
+                    : std::min( distance( weakKing, 7 ), distance( weakKing, 56 ) );
+
+    const int sign = strongSide == WHITE ? 1 : -1;
+    const int bonus = KNOWN_WIN_BONUS + PUSH_TO_CORNER_BONUS * ( 7 - cornerDistance ) +
+                      PUSH_CLOSE_BONUS * ( 7 - distance( strongKing, weakKing ) );
+
+    return board.score[END_GAME] + sign * bonus;
+}
+
+/**
+ * Evaluates king and pawn against a bare king using the KPK bitbase.
+ * Won positions are rewarded for advancing the pawn.
+ *
+ * @param board position to examine.
+ * @param strongSide side with the pawn.
+ *
+ * @return int score for the board, positive for white.
+ */
+int Endgame::evaluateKPK( const Board &board, PieceColor strongSide ) {
+    bool win;
+    if ( !Bitbase::probe( board, win ) ) {
+        return board.score[END_GAME];
+    }
+    if ( !win ) {
+        return 0;
+    }
+
+    SquareIndex pawn = NULL_SQUARE;
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        const auto &piece = board.squares[square];
+        if ( piece != std::nullopt && piece->type == PAWN ) {
+            pawn = square;
+        }
+    }
+
+    // White pawns promote on row 0, black pawns on row 7
+    const int pawnDistance = strongSide == WHITE ? pawn / 8 : 7 - pawn / 8;
+    const int sign = strongSide == WHITE ? 1 : -1;
+    return board.score[END_GAME] + sign * ( KNOWN_WIN_BONUS - PUSH_CLOSE_BONUS * pawnDistance );
+}
@@ -1,5 +1,8 @@
 #include "Engine.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 Engine::Engine() : moveGenerator( PieceValidMoves() ) { newGame(); }
 
 void Engine::newGame() {
@@ -29,3 +32,162 @@ bool Engine::makeMove( SquareIndex src, SquareIndex dest, PieceType promotion )
 
     return true;
 }
+
+void Engine::loadOpeningBook( const std::string &path ) { openingBook = std::make_unique<OpeningBook>( path ); }
+
+/**
+ * Returns the best move for the side to move.
+ * Legal book move is returned immediately, otherwise the position is searched.
+ *
+ * @param depth maximum depth of search.
+ *
+ * @return MoveContent representing the best move for the side to move.
+ */
+MoveContent Engine::getBestMove( int depth ) {
+    if ( const auto bookMove = getBookMove() ) {
+        return *bookMove;
+    }
+
+    return search.getBestMove( *board, depth );
+}
+
+std::vector<PvLine> Engine::getBestLines( const SearchLimits &limits ) {
+    std::atomic<bool> stop = false;
+    return search.searchLines( *board, limits, stop );
+}
+
+/**
+ * Starts searching the current position without blocking the caller.
+ * Legal book move is the result immediately, otherwise the position is searched within the limits.
+ * Number of threads of the search is taken from the engine's search.
+ *
+ * @param limits depth, node and time limits of the search.
+ * @param onInfo optional callback receiving the search progress, called from the search thread.
+ *
+ * @return SearchHandle used to stop the search and to get the best move.
+ */
+SearchHandle Engine::startSearch( const SearchLimits &limits, SearchCallback onInfo ) {
+    if ( const auto bookMove = getBookMove() ) {
+        return SearchHandle( *bookMove );
+    }
+
+    return SearchHandle( *board, search.getThreads(), limits, std::move( onInfo ) );
+}
+
+/**
+ * Starts searching the position after the expected opponent's move, before the opponent plays it.
+ * Time limit of the search applies only after SearchHandle::ponderHit, time is counted from the start though.
+ * If the opponent plays another move, the search is stopped and its result discarded.
+ *
+ * @param expectedMove opponent's move to ponder on, usually the second move of the last principal variation.
+ * @param limits limits of the search, clock times as they will be after the expected move.
+ * @param onInfo optional callback receiving the search progress, called from the search thread.
+ *
+ * @return SearchHandle used to report the ponder hit, to stop the search and to get the best move.
+ */
+SearchHandle Engine::startPondering( const MoveContent &expectedMove, const SearchLimits &limits,
+                                     SearchCallback onInfo ) {
+    if ( !isLegalMove( expectedMove ) ) {
+        throw std::invalid_argument( "Expected move is not legal" );
+    }
+
+    Board ponderBoard = *board;
+    ponderBoard.makeMove( expectedMove.src, expectedMove.dest, expectedMove.promotion );
+    moveGenerator.generateValidMoves( ponderBoard );
+
+    return SearchHandle( ponderBoard, search.getThreads(), limits, std::move( onInfo ), true );
+}
+
+std::optional<MoveContent> Engine::getBookMove() {
+    if ( openingBook != nullptr ) {
+        const auto bookMove = openingBook->probe( *board );
+        if ( bookMove && isLegalMove( *bookMove ) ) {
+            return bookMove;
+        }
+    }
+    return std::nullopt;
+}
+
+// Book moves come from an external file and have to be checked before playing them
+bool Engine::isLegalMove( const MoveContent &move ) {
+    const auto possibleMoves = search.getPossibleMoves( *board );
+    const bool isPossible = std::any_of( possibleMoves.cbegin(), possibleMoves.cend(), [&]( const auto &possible ) {
+        return possible.src == move.src && possible.dest == move.dest && possible.promotion == move.promotion;
+    } );
+    if ( !isPossible ) {
+        return false;
+    }
+
+    Board examineBoard = *board;
+    examineBoard.makeMove( move.src, move.dest, move.promotion );
+    moveGenerator.generateValidMoves( examineBoard );
+    const bool isLegal = moveGenerator.validateBoard( examineBoard );
+
+    // Engine always keeps the board with pseudo valid moves calculated!
+    moveGenerator.generateValidMoves( *board );
+    return isLegal;
+}
+
+/* ------------------------------ Search handle ----------------------------- */
+
+SearchHandle::SearchHandle( const Board &board, int threads, const SearchLimits &limits, SearchCallback onInfo,
+                            bool ponder )
+    : state_( std::make_unique<State>() ) {
+    state_->board = board;
+    state_->search.setThreads( threads );
+    if ( ponder ) {
+        state_->search.startPondering();
+    }
+    bestMove_ = state_->result.get_future().share();
+
+    thread_ = std::thread( [state = state_.get(), limits, onInfo = std::move( onInfo )] {
+        try {
+            state->result.set_value( state->search.search( state->board, limits, state->stop, onInfo ) );
+        } catch ( ... ) {
+            state->result.set_exception( std::current_exception() );
+        }
+    } );
+}
+
+SearchHandle::SearchHandle( const MoveContent &bookMove ) : state_( std::make_unique<State>() ) {
+    bestMove_ = state_->result.get_future().share();
+    state_->result.set_value( bookMove );
+}
+
+SearchHandle::~SearchHandle() {
+    stop();
+    wait();
+}
+
+SearchHandle &SearchHandle::operator=( SearchHandle &&other ) {
+    if ( this != &other ) {
+        stop();
+        wait();
+        state_ = std::move( other.state_ );
+        bestMove_ = std::move( other.bestMove_ );
+        thread_ = std::move( other.thread_ );
+    }
+    return *this;
+}
+
+void SearchHandle::stop() {
+    if ( state_ != nullptr ) {
+        state_->stop = true;
+    }
+}
+
+void SearchHandle::ponderHit() {
+    if ( state_ != nullptr ) {
+        state_->search.ponderHit();
+    }
+}
+
+void SearchHandle::wait() {
+    if ( thread_.joinable() ) {
+        thread_.join();
+    }
+}
+
+bool SearchHandle::isFinished() const {
+    return !bestMove_.valid() || bestMove_.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
@@ -0,0 +1,230 @@
+#include "Epd.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "Movegen.h"
+
+/* ------------------------------ Constructors ------------------------------ */
+
+EpdSuite::EpdSuite( std::istream &in ) {
+    std::string line;
+    for ( int lineNumber = 1; std::getline( in, line ); lineNumber++ ) {
+        if ( line.find_first_not_of( " \t\r" ) == std::string::npos || line.front() == '#' ) {
+            continue;
+        }
+        positions_.push_back( parse( line ) );
+        if ( positions_.back().id.empty() ) {
+            positions_.back().id = std::to_string( lineNumber );
+        }
+    }
+}
+
+/* --------------------------------- Parsing -------------------------------- */
+
+/**
+ * Parses a single EPD line, for example: 7k/8/7K/8/8/8/8/5R2 w - - bm Rf8+; id "stalemate trap";
+ * Half move clock and full move number are taken from the hmvc and fmvn operations or from the two numbers after
+ * the FEN fields, other unknown operations are ignored.
+ *
+ * @param line EPD record.
+ *
+ * @return EpdPosition with the complete FEN, id is empty if the line has no id operation.
+ */
+EpdPosition EpdSuite::parse( const std::string &line ) {
+    std::istringstream stream( line );
+    std::string fields[4];
+    for ( auto &field : fields ) {
+        if ( !( stream >> field ) ) {
+            throw std::invalid_argument( "Invalid EPD - four FEN fields required" );
+        }
+    }
+
+    EpdPosition position;
+    std::string halfMoveClock = "0", fullMoveNumber = "1";
+
+    // Full FEN has the move counters after the four fields
+    auto isNumber = []( const std::string &text ) {
+        return !text.empty() && std::all_of( text.cbegin(), text.cend(), ::isdigit );
+    };
+    const auto operationsStart = stream.tellg();
+    std::string first, second;
+    if ( stream >> first >> second && isNumber( first ) && isNumber( second ) ) {
+        halfMoveClock = first;
+        fullMoveNumber = second;
+    } else {
+        stream.clear();
+        stream.seekg( operationsStart );
+    }
+
+    // Operations are separated by semicolons, operands in quotes can contain spaces
+    std::string rest;
+    std::getline( stream, rest );
+    std::vector<std::vector<std::string>> operations( 1 );
+    std::string token;
+    bool isQuoted = false;
+    for ( char c : rest + ';' ) {
+        if ( c == '"' ) {
+            isQuoted = !isQuoted;
+        } else if ( !isQuoted && ( c == ' ' || c == ';' ) ) {
+            if ( !token.empty() ) {
+                operations.back().push_back( token );
+                token.clear();
+            }
+            if ( c == ';' && !operations.back().empty() ) {
+                operations.emplace_back();
+            }
+        } else {
+            token += c;
+        }
+    }
+
+    for ( const auto &operation : operations ) {
+        if ( operation.empty() ) {
+            continue;
+        }
+        const std::string &opcode = operation.front();
+        const std::vector<std::string> operands( operation.begin() + 1, operation.end() );
+
+        if ( opcode == "bm" ) {
+            position.bestMoves.insert( position.bestMoves.end(), operands.cbegin(), operands.cend() );
+        } else if ( opcode == "am" ) {
+            position.avoidMoves.insert( position.avoidMoves.end(), operands.cbegin(), operands.cend() );
+        } else if ( opcode == "id" && !operands.empty() ) {
+            position.id = operands.front();
+        } else if ( opcode == "hmvc" && !operands.empty() ) {
+            halfMoveClock = operands.front();
+        } else if ( opcode == "fmvn" && !operands.empty() ) {
+            fullMoveNumber = operands.front();
+        }
+    }
+
+    position.fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3] + " " + halfMoveClock + " " +
+                   fullMoveNumber;
+    Board board( position.fen );  // Throws on invalid FEN
+
+    return position;
+}
+
+/**
+ * Checks if the move is described by the notation.
+ * Notation is either SAN (Nbd7, exd8=Q+, O-O) or UCI (b8d7, e7d8q).
+ * It assumes that the board has valid moves calculated.
+ *
+ * @param board position before the move.
+ * @param move move to compare.
+ * @param notation SAN or UCI move.
+ *
+ * @return true if the notation describes the move.
+ */
+bool EpdSuite::matchesMove( const Board &board, const MoveContent &move, const std::string &notation ) {
+    if ( notation == move.toUCI() ) {
+        return true;
+    }
+    const auto sanMove = MoveContent::fromPGN( board, notation );
+    return sanMove && *sanMove == move;
+}
+
+bool EpdSuite::isCorrect( const EpdPosition &position, const Board &board, const MoveContent &move ) {
+    auto matches = [&]( const std::string &notation ) { return matchesMove( board, move, notation ); };
+    const bool isBest = position.bestMoves.empty() || std::any_of( position.bestMoves.cbegin(),
+                                                                   position.bestMoves.cend(), matches );
+    const bool isAvoided = std::any_of( position.avoidMoves.cbegin(), position.avoidMoves.cend(), matches );
+    return isBest && !isAvoided;
+}
+
+/* --------------------------------- Running -------------------------------- */
+
+/**
+ * Searches all positions, each position by a single thread of the pool.
+ *
+ * @param limits limits of every position's search.
+ * @param threads number of positions searched concurrently.
+ *
+ * @return EpdReport with the results in the order of the positions.
+ */
+EpdReport EpdSuite::run( const SearchLimits &limits, int threads ) const {
+    EpdReport report;
+    report.results.resize( positions_.size() );
+    const auto start = std::chrono::steady_clock::now();
+
+    std::atomic<std::size_t> nextPosition = 0;
+    auto worker = [&] {
+        // Search keeps its move generator and plies, so every thread has its own
+        Search search;
+        for ( std::size_t i = nextPosition++; i < positions_.size(); i = nextPosition++ ) {
+            report.results[i] = runPosition( positions_[i], limits, search );
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for ( int i = 0; i < std::max( threads, 1 ); i++ ) {
+        pool.emplace_back( worker );
+    }
+    for ( auto &thread : pool ) {
+        thread.join();
+    }
+
+    report.time =
+        std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+    report.solved = std::count_if( report.results.cbegin(), report.results.cend(),
+                                   []( const EpdResult &result ) { return result.solved; } );
+    report.nodes = 0;
+    for ( const auto &result : report.results ) {
+        report.nodes += result.nodes;
+    }
+    report.nps = report.nodes * 1000 / std::max<int64_t>( report.time, 1 );
+    return report;
+}
+
+// Solution is the moment since which every completed iteration returned a correct move
+EpdResult EpdSuite::runPosition( const EpdPosition &position, const SearchLimits &limits, Search &search ) {
+    Board board( position.fen );
+    PieceValidMoves generator;
+    generator.generateValidMoves( board );
+
+    EpdResult result{ position.id, MoveContent(), false, -1, -1, 0, 0 };
+    std::atomic<bool> stop = false;
+    const auto start = std::chrono::steady_clock::now();
+
+    result.move = search.search( board, limits, stop, [&]( const SearchInfo &info ) {
+        result.nodes = std::max( result.nodes, info.nodes );
+        if ( !info.completed ) {
+            return;
+        }
+        if ( !isCorrect( position, board, info.bestMove ) ) {
+            result.timeToSolution = result.nodesToSolution = -1;
+        } else if ( result.timeToSolution < 0 ) {
+            result.timeToSolution = info.time;
+            result.nodesToSolution = info.nodes;
+        }
+    } );
+
+    result.time =
+        std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+    result.solved = isCorrect( position, board, result.move );
+    if ( !result.solved ) {
+        result.timeToSolution = result.nodesToSolution = -1;
+    }
+    return result;
+}
+
+/* --------------------------------- Output --------------------------------- */
+
+void EpdSuite::printReport( const EpdReport &report, std::ostream &out ) {
+    for ( const auto &result : report.results ) {
+        out << std::left << std::setw( 24 ) << result.id << std::setw( 8 ) << ( result.solved ? "solved" : "failed" )
+            << std::setw( 7 ) << result.move.toUCI();
+        if ( result.solved ) {
+            out << " time " << result.timeToSolution << " ms nodes " << result.nodesToSolution;
+        }
+        out << "\n";
+    }
+    out << "Solved " << report.solved << " of " << report.results.size() << " positions in " << report.time
+        << " ms, " << report.nodes << " nodes, " << report.nps << " nps" << std::endl;
+}
@@ -1,36 +1,278 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdlib>
 #include <numeric>
+#include <stdexcept>
 
 #include "Evaluation.h"
+#include "Material.h"
+#include "Trace.h"
+#include "Zobrist.h"
+
+/* ------------------------------- Pawn masks ------------------------------- */
+
+// Precalculated square sets used by the pawn structure evaluation, indexed by PieceColor and SquareIndex
+struct PawnMasks {
+    Bitboard files[8];
+    Bitboard adjacentFiles[8];
+    Bitboard passed[2][64];   // Squares in front of the pawn on its own and adjacent files
+    Bitboard support[2][64];  // Squares on adjacent files on the pawn's rank and behind it
+    Bitboard attacks[2][64];  // Squares attacked by the pawn
+    Bitboard shield[2][64];   // Two ranks in front of the king on its own and adjacent files
+};
+
+static PawnMasks generatePawnMasks() {
+    PawnMasks masks{};
+
+    for ( int square = 0; square < 64; square++ ) {
+        masks.files[square % 8] |= 1ULL << square;
+    }
+    for ( int file = 0; file < 8; file++ ) {
+        masks.adjacentFiles[file] = ( file > 0 ? masks.files[file - 1] : 0 ) | ( file < 7 ? masks.files[file + 1] : 0 );
+    }
+
+    for ( int square = 0; square < 64; square++ ) {
+        const int file = square % 8;
+        const int row = square / 8;  // Row 0 is the 8th rank, white pawns move towards lower rows
+
+        for ( int other = 0; other < 64; other++ ) {
+            const int otherFile = other % 8;
+            const int otherRow = other / 8;
+            const Bitboard bit = 1ULL << other;
+            const bool sameOrAdjacentFile = std::abs( otherFile - file ) <= 1;
+            const bool adjacentFile = std::abs( otherFile - file ) == 1;
+
+            if ( sameOrAdjacentFile && otherRow < row ) masks.passed[WHITE][square] |= bit;
+            if ( sameOrAdjacentFile && otherRow > row ) masks.passed[BLACK][square] |= bit;
+            if ( adjacentFile && otherRow >= row ) masks.support[WHITE][square] |= bit;
+            if ( adjacentFile && otherRow <= row ) masks.support[BLACK][square] |= bit;
+            if ( adjacentFile && otherRow == row - 1 ) masks.attacks[WHITE][square] |= bit;
+            if ( adjacentFile && otherRow == row + 1 ) masks.attacks[BLACK][square] |= bit;
+            if ( sameOrAdjacentFile && otherRow < row && otherRow >= row - 2 ) masks.shield[WHITE][square] |= bit;
+            if ( sameOrAdjacentFile && otherRow > row && otherRow <= row + 2 ) masks.shield[BLACK][square] |= bit;
+        }
+    }
+
+    return masks;
+}
+
+static const PawnMasks PAWN_MASKS = generatePawnMasks();
+
+/* ------------------------------- Evaluation ------------------------------- */
 
 int Evaluation::evaluateBoard( const Board &board ) {
+    TRACE_SCOPE( "Evaluation::evaluateBoard" );
+#ifdef EVALUATION_DEBUG
+    // Incrementally updated values have to match the full recalculation
+    assert( board.score[MIDDLE_GAME] == computeScore( board, MIDDLE_GAME ) );
+    assert( board.score[END_GAME] == computeScore( board, END_GAME ) );
+    assert( board.materialKey == computeMaterialKey( board ) );
+    assert( board.pawnKey == computePawnKey( board ) );
+    assert( board.kingSquares == findKingSquares( board ) );
+#endif
+
+    // Drawn material and specialized endgames replace the general evaluation
+    const MaterialEntry &material = MaterialTable::getInstance().probe( board.materialKey );
+    if ( material.knownDraw ) {
+        return 0;
+    }
+    if ( material.endgame != nullptr ) {
+        return material.endgame( board, material.strongSide );
+    }
+
+    // Material and piece positions are accumulated by Board::makeMove
+    int middleGame = board.score[MIDDLE_GAME] + material.imbalance;
+    int endGame = board.score[END_GAME] + material.imbalance;
+
+    // Pawn structure is almost always found in the pawn hash table
+    const PawnEntry &pawns = probePawnStructure( board );
+    middleGame += pawns.score[MIDDLE_GAME];
+    endGame += pawns.score[END_GAME];
+
+    // Pawn shield in front of the kings
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        const SquareIndex king = board.kingSquares[color];
+        if ( king == NULL_SQUARE ) continue;
+        const int sign = color == WHITE ? 1 : -1;
+        const int shieldPawns = std::popcount( pawns.pawns[color] & PAWN_MASKS.shield[color][king] );
+        middleGame += sign * shieldPawns * PAWN_SHIELD_BONUS[MIDDLE_GAME];
+        endGame += sign * shieldPawns * PAWN_SHIELD_BONUS[END_GAME];
+    }
+
+    // Interpolate between middle game and end game scores
+    int score = ( middleGame * material.phase + endGame * ( TOTAL_PHASE - material.phase ) ) / TOTAL_PHASE;
+
+    return score;
+}
+
+int Evaluation::computeScore( const Board &board, GameStage stage ) {
     int score = 0;
 
     for ( SquareIndex square = 0; square < 64; square++ ) {
         if ( board.squares[square] != std::nullopt ) {
-            const auto piece = board.squares[square];
-            const auto color = piece->color;
-
-            /* ----------------------- Accumulate material balance ---------------------- */
-            score += color == WHITE ? piece->value : -piece->value;
-
-            /* ------------------------- Evaluate piece position ------------------------ */
-            switch ( piece->type ) {
-                case PAWN:
-                    score += color == WHITE ? PAWN_TABLE[square] : -PAWN_TABLE[63 - square];
-                    break;
-                case KNIGHT:
-                    score += color == WHITE ? KNIGHT_TABLE[square] : -KNIGHT_TABLE[63 - square];
-                    break;
-                case BISHOP:
-                    score += color == WHITE ? BISHOP_TABLE[square] : -BISHOP_TABLE[63 - square];
-                    break;
-                case KING:
-                    score += color == WHITE ? KING_TABLE[square] : -KING_TABLE[63 - square];
-                    break;
-                default:
-                    break;
-            }
+            const auto &piece = board.squares[square];
+            score += pieceSquareScore( stage, piece->color, piece->type, square );
         }
     }
     return score;
 }
+
+uint64_t Evaluation::computeMaterialKey( const Board &board ) {
+    uint64_t key = 0;
+
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        const auto &piece = board.squares[square];
+        if ( piece != std::nullopt ) {
+            key += MaterialTable::materialKeyUnit( piece->color, piece->type );
+        }
+    }
+    return key;
+}
+
+uint64_t Evaluation::computePawnKey( const Board &board ) {
+    uint64_t key = 0;
+
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        const auto &piece = board.squares[square];
+        if ( piece != std::nullopt && piece->type == PAWN ) {
+            key ^= Zobrist::pieceKey( piece->color, PAWN, square );
+        }
+    }
+    return key;
+}
+
+std::array<SquareIndex, 2> Evaluation::findKingSquares( const Board &board ) {
+    std::array<SquareIndex, 2> kingSquares = { NULL_SQUARE, NULL_SQUARE };
+
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        const auto &piece = board.squares[square];
+        if ( piece != std::nullopt && piece->type == KING ) {
+            kingSquares[piece->color] = square;
+        }
+    }
+    return kingSquares;
+}
+
+/* ----------------------------- Pawn structure ----------------------------- */
+
+static std::atomic<std::size_t> pawnHashSize = PAWN_HASH_TABLE_SIZE;
+
+PawnHashTable &Evaluation::getPawnHashTable() {
+    static thread_local PawnHashTable pawnHashTable;
+    if ( pawnHashTable.size() != pawnHashSize.load( std::memory_order_relaxed ) ) {
+        pawnHashTable = PawnHashTable( pawnHashSize );
+    }
+    return pawnHashTable;
+}
+
+void Evaluation::setPawnHashSize( std::size_t size ) {
+    if ( !std::has_single_bit( size ) ) {
+        throw std::invalid_argument( "Pawn hash table size has to be a power of two!" );
+    }
+    pawnHashSize = size;
+}
+
+const PawnEntry &Evaluation::probePawnStructure( const Board &board ) {
+    bool found;
+    PawnEntry &entry = getPawnHashTable().probe( board.pawnKey, found );
+    if ( !found ) {
+        evaluatePawnStructure( board, entry );
+        entry.key = board.pawnKey;
+    }
+    return entry;
+}
+
+PawnTerms Evaluation::countPawnTerms( const Board &board ) {
+    PawnEntry entry;
+    PawnTerms terms;
+    countPawns( board, entry, terms );
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        const SquareIndex king = board.kingSquares[color];
+        if ( king != NULL_SQUARE ) {
+            terms.shield[color] = std::popcount( entry.pawns[color] & PAWN_MASKS.shield[color][king] );
+        }
+    }
+    return terms;
+}
+
+// Weights the pawn structure terms by the evaluation parameters
+void Evaluation::evaluatePawnStructure( const Board &board, PawnEntry &entry ) {
+    PawnTerms terms;
+    countPawns( board, entry, terms );
+
+    for ( GameStage stage : { MIDDLE_GAME, END_GAME } ) {
+        entry.score[stage] = 0;
+        for ( PieceColor color : { WHITE, BLACK } ) {
+            int score = -terms.doubled[color] * DOUBLED_PAWN_PENALTY[stage] -
+                        terms.isolated[color] * ISOLATED_PAWN_PENALTY[stage] -
+                        terms.backward[color] * BACKWARD_PAWN_PENALTY[stage];
+            for ( int rank = 0; rank < 8; rank++ ) {
+                score += terms.passed[color][rank] * PASSED_PAWN_BONUS[stage][rank];
+            }
+            entry.score[stage] += color == WHITE ? score : -score;
+        }
+    }
+}
+
+/**
+ * Counts doubled, isolated, backward and passed pawns and records pawn square sets.
+ *
+ * @param board position to examine.
+ * @param entry pawn hash table entry to fill with the square sets.
+ * @param terms pawn structure terms to fill, pawn shield is counted separately as it depends on the kings.
+ */
+void Evaluation::countPawns( const Board &board, PawnEntry &entry, PawnTerms &terms ) {
+    entry.pawns[WHITE] = entry.pawns[BLACK] = 0;
+    entry.pawnAttacks[WHITE] = entry.pawnAttacks[BLACK] = 0;
+    entry.passedPawns[WHITE] = entry.passedPawns[BLACK] = 0;
+    terms = PawnTerms{};
+
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        const auto &piece = board.squares[square];
+        if ( piece != std::nullopt && piece->type == PAWN ) {
+            entry.pawns[piece->color] |= 1ULL << square;
+            entry.pawnAttacks[piece->color] |= PAWN_MASKS.attacks[piece->color][square];
+        }
+    }
+
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        const PieceColor enemy = color == WHITE ? BLACK : WHITE;
+        const Bitboard ownPawns = entry.pawns[color];
+        const Bitboard enemyPawns = entry.pawns[enemy];
+
+        // Doubled pawns - every pawn after the first one on a file
+        for ( int file = 0; file < 8; file++ ) {
+            const int pawnsOnFile = std::popcount( ownPawns & PAWN_MASKS.files[file] );
+            if ( pawnsOnFile > 1 ) {
+                terms.doubled[color] += pawnsOnFile - 1;
+            }
+        }
+
+        for ( Bitboard pawns = ownPawns; pawns; pawns &= pawns - 1 ) {
+            const int square = std::countr_zero( pawns );
+            const int file = square % 8;
+            const int relativeRank = color == WHITE ? 7 - square / 8 : square / 8;
+            const int frontSquare = color == WHITE ? square - 8 : square + 8;
+
+            // Isolated pawn - no allied pawns on adjacent files
+            const bool isolated = ( ownPawns & PAWN_MASKS.adjacentFiles[file] ) == 0;
+            if ( isolated ) {
+                terms.isolated[color]++;
+            }
+            // Backward pawn - cannot be supported by allied pawns and cannot advance safely
+            else if ( ( ownPawns & PAWN_MASKS.support[color][square] ) == 0 &&
+                      ( entry.pawnAttacks[enemy] & ( 1ULL << frontSquare ) ) ) {
+                terms.backward[color]++;
+            }
+
+            // Passed pawn - no enemy pawns can stop it and it is the front pawn on its file
+            const Bitboard front = PAWN_MASKS.passed[color][square];
+            if ( ( enemyPawns & front ) == 0 && ( ownPawns & front & PAWN_MASKS.files[file] ) == 0 ) {
+                entry.passedPawns[color] |= 1ULL << square;
+                terms.passed[color][relativeRank]++;
+            }
+        }
+    }
+}
@@ -0,0 +1,235 @@
+#include "Match.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#include "Material.h"
+#include "Movegen.h"
+#include "Polyglot.h"
+
+// Neither side can mate against any defence: bare kings, a single minor piece or two knights against a bare king
+static bool isDeadPosition( uint64_t materialKey ) {
+    auto count = [&]( PieceColor color, PieceType type ) {
+        return MaterialTable::pieceCount( materialKey, color, type );
+    };
+    std::array<int, 2> minors;
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        if ( count( color, PAWN ) > 0 || count( color, ROOK ) > 0 || count( color, QUEEN ) > 0 ) {
+            return false;
+        }
+        minors[color] = count( color, KNIGHT ) + count( color, BISHOP );
+    }
+
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        const PieceColor them = color == WHITE ? BLACK : WHITE;
+        if ( minors[them] == 0 ) {
+            return minors[color] <= 1 || ( minors[color] == 2 && count( color, KNIGHT ) == 2 );
+        }
+    }
+    return false;
+}
+
+/* ------------------------------ Constructors ------------------------------ */
+
+Match::Match( const MatchPlayer& first, const MatchPlayer& second, const std::vector<std::string>& openings,
+              const MatchOptions& options )
+    : first_( first ), second_( second ), openings_( openings ), options_( options ) {
+    if ( openings_.empty() ) {
+        openings_.push_back( Board().toFEN() );
+    }
+}
+
+/* --------------------------------- Playing -------------------------------- */
+
+/**
+ * Plays the games on options.concurrency threads, every thread has its own searches for both players.
+ * Games 2n and 2n + 1 share an opening, the first player is white in the even games.
+ *
+ * @param onGame optional callback receiving the result after every game.
+ *
+ * @return MatchReport of all games played, fewer than options.games if the SPRT has finished early.
+ */
+MatchReport Match::run( const MatchCallback& onGame ) const {
+    std::atomic<int> nextGame = 0;
+    std::atomic<bool> isDecided = false;
+    std::mutex mutex;
+    int wins = 0, draws = 0, losses = 0;
+
+    auto worker = [&] {
+        Search firstSearch, secondSearch;
+        firstSearch.setThreads( first_.threads );
+        secondSearch.setThreads( second_.threads );
+        for ( int game = nextGame++; game < options_.games && !isDecided; game = nextGame++ ) {
+            const std::string& opening = openings_[game / 2 % openings_.size()];
+            const int result = game % 2 == 0 ? playGame( opening, first_, second_, firstSearch, secondSearch )
+                                             : -playGame( opening, second_, first_, secondSearch, firstSearch );
+
+            std::lock_guard<std::mutex> lock( mutex );
+            wins += result > 0;
+            draws += result == 0;
+            losses += result < 0;
+            const MatchReport report = makeReport( wins, draws, losses, options_ );
+            if ( options_.sprt && report.sprtResult != 0 ) {
+                isDecided = true;
+            }
+            if ( onGame ) {
+                onGame( report );
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for ( int i = 0; i < std::max( options_.concurrency, 1 ); i++ ) {
+        pool.emplace_back( worker );
+    }
+    for ( auto& thread : pool ) {
+        thread.join();
+    }
+    return makeReport( wins, draws, losses, options_ );
+}
+
+/**
+ * Plays a single game from the opening position.
+ * Player's limits are combined with the match control, the tighter node limit applies.
+ *
+ * @param opening FEN of the starting position.
+ * @param white player of the white pieces.
+ * @param black player of the black pieces.
+ * @param whiteSearch search used by the white player.
+ * @param blackSearch search used by the black player.
+ *
+ * @return 1 if white won, 0 for a draw and -1 if black won.
+ */
+int Match::playGame( const std::string& opening, const MatchPlayer& white, const MatchPlayer& black,
+                     Search& whiteSearch, Search& blackSearch ) const {
+    Board board( opening );
+    PieceValidMoves generator;
+    std::array<int, 2> clock = { options_.time, options_.time };
+    std::vector<uint64_t> keys = { OpeningBook::polyglotKey( board ) };
+    int drawPlies = 0;
+
+    for ( int ply = 0;; ply++ ) {
+        const PieceColor us = board.sideToMove;
+        const int lost = us == WHITE ? -1 : 1;  // Result if the side to move loses
+
+        // Draws by rule and by the move limit
+        if ( board.halfMoveClock() >= 100 || isDeadPosition( board.materialKey ) ||
+             std::count( keys.cbegin(), keys.cend(), keys.back() ) >= 3 || ply >= 2 * options_.maxMoves ) {
+            return 0;
+        }
+
+        const MatchPlayer& player = us == WHITE ? white : black;
+        SearchLimits limits = player.limits;
+        if ( options_.nodes > 0 ) {
+            limits.nodes = limits.nodes > 0 ? std::min( limits.nodes, options_.nodes ) : options_.nodes;
+        }
+        if ( options_.time > 0 ) {
+            limits.time = clock;
+            limits.increment = { options_.increment, options_.increment };
+        }
+
+        generator.generateValidMoves( board );
+        std::atomic<bool> stop = false;
+        const auto start = std::chrono::steady_clock::now();
+        const auto lines = ( us == WHITE ? whiteSearch : blackSearch ).searchLines( board, limits, stop );
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+
+        // Mate or stalemate
+        if ( lines.empty() ) {
+            const bool isChecked = us == WHITE ? board.whiteIsChecked : board.blackIsChecked;
+            return isChecked ? lost : 0;
+        }
+
+        if ( options_.time > 0 ) {
+            clock[us] -= elapsed;
+            if ( clock[us] < 0 ) {
+                return lost;
+            }
+            clock[us] += options_.increment;
+        }
+
+        // Adjudication by the score of the player
+        const int score = lines.front().score;
+        if ( score == POSITIVE_INFINITY || score == NEGATIVE_INFINITY ) {
+            return score == POSITIVE_INFINITY ? 1 : -1;
+        }
+        drawPlies = std::abs( score ) <= options_.drawScore ? drawPlies + 1 : 0;
+        if ( ply / 2 + 1 >= options_.drawMoveNumber && drawPlies >= 2 * options_.drawMoveCount ) {
+            return 0;
+        }
+
+        const MoveContent& move = lines.front().pv.front();
+        board.makeMove( move.src, move.dest, move.promotion );
+        keys.push_back( OpeningBook::polyglotKey( board ) );
+    }
+}
+
+/* --------------------------------- Results -------------------------------- */
+
+/**
+ * Calculates the Elo difference and the SPRT log likelihood ratio of the game results.
+ * Variance of the game score is taken from the results, the LLR uses the normal approximation of the score.
+ *
+ * @param wins games won by the first player.
+ * @param draws drawn games.
+ * @param losses games lost by the first player.
+ * @param options SPRT hypotheses and error probabilities.
+ *
+ * @return MatchReport of the results.
+ */
+MatchReport Match::makeReport( int wins, int draws, int losses, const MatchOptions& options ) {
+    MatchReport report = { wins, draws, losses, 0.0, 0.0, 0.0, 0.0, 0.0, 0 };
+    report.lowerBound = std::log( options.beta / ( 1 - options.alpha ) );
+    report.upperBound = std::log( ( 1 - options.beta ) / options.alpha );
+
+    const int games = wins + draws + losses;
+    if ( games == 0 ) {
+        return report;
+    }
+    const double score = ( wins + 0.5 * draws ) / games;
+    const double variance =
+        ( wins * std::pow( 1 - score, 2 ) + draws * std::pow( 0.5 - score, 2 ) + losses * std::pow( score, 2 ) ) /
+        games;
+    const double error = 1.96 * std::sqrt( variance / games );
+    report.elo = scoreToElo( score );
+    report.eloError = ( scoreToElo( score + error ) - scoreToElo( score - error ) ) / 2;
+
+    // Half a game is added to every result, so the LLR is defined even if all games ended the same way
+    const double w = wins + 0.5, d = draws + 0.5, l = losses + 0.5, n = games + 1.5;
+    const double llrScore = ( w + 0.5 * d ) / n;
+    const double llrVariance =
+        ( w * std::pow( 1 - llrScore, 2 ) + d * std::pow( 0.5 - llrScore, 2 ) + l * std::pow( llrScore, 2 ) ) / n;
+    const double score0 = eloToScore( options.elo0 );
+    const double score1 = eloToScore( options.elo1 );
+    report.llr = n * ( score1 - score0 ) * ( 2 * llrScore - score0 - score1 ) / ( 2 * llrVariance );
+    report.sprtResult = report.llr >= report.upperBound ? 1 : report.llr <= report.lowerBound ? -1 : 0;
+    return report;
+}
+
+// Score is clamped, so the Elo of a match without a single lost or won game is finite
+double Match::scoreToElo( double score ) {
+    score = std::clamp( score, 0.001, 0.999 );
+    return -400.0 * std::log10( 1.0 / score - 1.0 );
+}
+
+double Match::eloToScore( double elo ) {
+    return 1.0 / ( 1.0 + std::pow( 10.0, -elo / 400.0 ) );
+}
+
+void Match::printReport( const MatchReport& report, std::ostream& out ) {
+    out << "Games " << report.wins + report.draws + report.losses << ": +" << report.wins << " =" << report.draws
+        << " -" << report.losses << std::fixed << std::setprecision( 1 ) << ", Elo " << report.elo << " +/- "
+        << report.eloError << std::setprecision( 2 ) << ", LLR " << report.llr << " (" << report.lowerBound << ", "
+        << report.upperBound << ")";
+    if ( report.sprtResult != 0 ) {
+        out << ( report.sprtResult > 0 ? " H1 accepted" : " H0 accepted" );
+    }
+    out << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,142 @@
+#include "Material.h"
+
+#include <algorithm>
+
+#include "Endgame.h"
+
+/* ------------------------------ Constructors ------------------------------ */
+
+MaterialTable::MaterialTable() : entries_( ENTRIES_PER_COLOR * ENTRIES_PER_COLOR ) {
+    // Enumerate every material configuration within the table limits
+    for ( int white = 0; white < ENTRIES_PER_COLOR; white++ ) {
+        for ( int black = 0; black < ENTRIES_PER_COLOR; black++ ) {
+            uint64_t materialKey = 0;
+            int index[2] = { white, black };
+
+            for ( PieceColor color : { WHITE, BLACK } ) {
+                for ( PieceType type : { PAWN, KNIGHT, BISHOP, ROOK, QUEEN } ) {
+                    const int radix = MAX_COUNTS[type] + 1;
+                    materialKey += ( index[color] % radix ) * materialKeyUnit( color, type );
+                    index[color] /= radix;
+                }
+            }
+
+            entries_[white * ENTRIES_PER_COLOR + black] = computeEntry( materialKey );
+        }
+    }
+}
+
+/* --------------------------------- Methods -------------------------------- */
+
+const MaterialEntry &MaterialTable::probe( uint64_t materialKey ) const {
+    const int white = colorIndex( materialKey, WHITE );
+    const int black = colorIndex( materialKey, BLACK );
+
+    if ( white >= 0 && black >= 0 ) {
+        return entries_[white * ENTRIES_PER_COLOR + black];
+    }
+
+    // Material out of the table limits
+    static thread_local MaterialEntry entry;
+    entry = computeEntry( materialKey );
+    return entry;
+}
+
+// Returns index of the color's material within the table or -1 if any piece count exceeds the table limits
+int MaterialTable::colorIndex( uint64_t materialKey, PieceColor color ) {
+    int index = 0;
+
+    for ( PieceType type : { QUEEN, ROOK, BISHOP, KNIGHT, PAWN } ) {
+        const int count = pieceCount( materialKey, color, type );
+        if ( count > MAX_COUNTS[type] ) {
+            return -1;
+        }
+        index = index * ( MAX_COUNTS[type] + 1 ) + count;
+    }
+
+    return index;
+}
+
+/**
+ * Calculates evaluation terms for the given material configuration.
+ *
+ * @param materialKey material configuration.
+ *
+ * @return game phase, imbalance, draw flag and specialized endgame evaluation for the material.
+ */
+MaterialEntry MaterialTable::computeEntry( uint64_t materialKey ) {
+    MaterialEntry entry{ 0, 0, false, WHITE, nullptr };
+    int pawns[2], knights[2], bishops[2], rooks[2], queens[2];
+
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        pawns[color] = pieceCount( materialKey, color, PAWN );
+        knights[color] = pieceCount( materialKey, color, KNIGHT );
+        bishops[color] = pieceCount( materialKey, color, BISHOP );
+        rooks[color] = pieceCount( materialKey, color, ROOK );
+        queens[color] = pieceCount( materialKey, color, QUEEN );
+
+        /* ------------------------------- Game phase ------------------------------- */
+        for ( PieceType type : { KNIGHT, BISHOP, ROOK, QUEEN } ) {
+            entry.phase += pieceCount( materialKey, color, type ) * PIECE_PHASES[type];
+        }
+
+        /* -------------------------------- Imbalance ------------------------------- */
+        int imbalance = 0;
+        if ( bishops[color] >= 2 ) {
+            imbalance += BISHOP_PAIR_BONUS;
+        }
+        // Knights gain value in closed positions with many pawns, rooks in open positions
+        imbalance += knights[color] * ( pawns[color] - 5 ) * KNIGHT_PAWN_ADJUSTMENT;
+        imbalance += rooks[color] * ( pawns[color] - 5 ) * ROOK_PAWN_ADJUSTMENT;
+        entry.imbalance += color == WHITE ? imbalance : -imbalance;
+    }
+    entry.phase = std::min( entry.phase, TOTAL_PHASE );
+
+    /* ------------------------------- Known draws ------------------------------ */
+    const bool noPawns = pawns[WHITE] == 0 && pawns[BLACK] == 0;
+    bool cannotMate[2];
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        const int minors = knights[color] + bishops[color];
+        const bool onlyMinors = rooks[color] == 0 && queens[color] == 0;
+        cannotMate[color] = onlyMinors && ( minors <= 1 || ( knights[color] == 2 && bishops[color] == 0 ) );
+    }
+    // Two knights cannot force a mate only against a bare king
+    const bool bareKing[2] = { knights[WHITE] + bishops[WHITE] + rooks[WHITE] + queens[WHITE] == 0,
+                               knights[BLACK] + bishops[BLACK] + rooks[BLACK] + queens[BLACK] == 0 };
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        const PieceColor enemy = color == WHITE ? BLACK : WHITE;
+        if ( knights[color] == 2 && !bareKing[enemy] ) {
+            cannotMate[color] = false;
+        }
+    }
+    if ( noPawns && cannotMate[WHITE] && cannotMate[BLACK] ) {
+        entry.knownDraw = true;
+        return entry;
+    }
+
+    /* -------------------------- Specialized endgames -------------------------- */
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        const PieceColor enemy = color == WHITE ? BLACK : WHITE;
+        if ( !bareKing[enemy] || pawns[enemy] != 0 ) {
+            continue;
+        }
+
+        // King and pawn against king
+        if ( bareKing[color] && pawns[color] == 1 ) {
+            entry.strongSide = color;
+            entry.endgame = Endgame::evaluateKPK;
+        }
+        // King, bishop and knight against king
+        else if ( noPawns && knights[color] == 1 && bishops[color] == 1 && rooks[color] + queens[color] == 0 ) {
+            entry.strongSide = color;
+            entry.endgame = Endgame::evaluateKBNK;
+        }
+        // King and major pieces against king
+        else if ( noPawns && rooks[color] + queens[color] > 0 ) {
+            entry.strongSide = color;
+            entry.endgame = Endgame::evaluateKXK;
+        }
+    }
+
+    return entry;
+}
@@ -1,5 +1,43 @@
 #include "MoveContent.h"
 
+#include <algorithm>
+
+#include "Board.h"
+#include "Movegen.h"
+
+static bool isPromotion( const Piece &piece, SquareIndex dest ) {
+    return piece.type == PAWN && ( dest < 8 || dest > 55 );
+}
+
+// Returns true if the pseudo legal move does not leave the king in check, promotion piece does not matter for that
+static bool isLegal( const Board &board, SquareIndex src, SquareIndex dest, PieceType promotion,
+                     PieceValidMoves &generator ) {
+    if ( promotion == EMPTY && isPromotion( *board.squares[src], dest ) ) {
+        promotion = QUEEN;
+    }
+    Board examineBoard = board;
+    examineBoard.makeMove( src, dest, promotion );
+    generator.generateValidMoves( examineBoard );
+    return generator.validateBoard( examineBoard );
+}
+
+static char pieceLetter( PieceType type ) {
+    switch ( type ) {
+        case KNIGHT:
+            return 'N';
+        case BISHOP:
+            return 'B';
+        case ROOK:
+            return 'R';
+        case QUEEN:
+            return 'Q';
+        case KING:
+            return 'K';
+        default:
+            return 0;
+    }
+}
+
 MoveContent::MoveContent( SquareIndex src, SquareIndex dest, PieceType promotion, PieceType pieceMoving,
                           PieceType pieceTaken, bool isEnPassantCapture, int score )
     : src( src ),
@@ -23,8 +61,199 @@ bool MoveContent::operator==( const MoveContent& other ) const {
     return src == other.src && dest == other.dest && promotion == other.promotion;
 }
 
-// TODO
-std::string MoveContent::toPGN() const { return "O-O-O"; }
+/**
+ * Writes the move in standard algebraic notation.
+ * Source file or rank is added only if another piece of the same type can legally move to the destination.
+ * It assumes that the move is legal and the board has valid moves calculated.
+ *
+ * @param board position before the move.
+ *
+ * @return SAN of the move with check (+) or mate (#) suffix.
+ */
+std::string MoveContent::toPGN( const Board &board ) const {
+    const Piece &piece = *board.squares[src];
+    const bool isCapture = board.squares[dest].has_value() || ( piece.type == PAWN && src % 8 != dest % 8 );
+    // Promotion without the piece given is a queen promotion, as in isLegal
+    const PieceType promotedTo = promotion == EMPTY && isPromotion( piece, dest ) ? QUEEN : promotion;
+    std::string san;
+
+    if ( piece.type == KING && ( dest == src + 2 || dest + 2 == src ) ) {
+        san = dest > src ? "O-O" : "O-O-O";
+    } else if ( piece.type == PAWN ) {
+        if ( isCapture ) {
+            san += char( 'a' + src % 8 );
+            san += 'x';
+        }
+        san += { char( 'a' + dest % 8 ), char( '8' - dest / 8 ) };
+        if ( promotedTo != EMPTY ) {
+            san += { '=', pieceLetter( promotedTo ) };
+        }
+    } else {
+        PieceValidMoves generator;
+        bool isAmbiguous = false, sharesFile = false, sharesRank = false;
+        for ( SquareIndex square = 0; square < 64; square++ ) {
+            const auto &other = board.squares[square];
+            if ( square == src || !other || other->color != piece.color || other->type != piece.type ||
+                 std::find( other->validMoves.cbegin(), other->validMoves.cend(), dest ) == other->validMoves.cend() ||
+                 !isLegal( board, square, dest, EMPTY, generator ) ) {
+                continue;
+            }
+            isAmbiguous = true;
+            sharesFile |= square % 8 == src % 8;
+            sharesRank |= square / 8 == src / 8;
+        }
+
+        san += pieceLetter( piece.type );
+        if ( isAmbiguous && ( !sharesFile || sharesRank ) ) {
+            san += char( 'a' + src % 8 );
+        }
+        if ( isAmbiguous && sharesFile ) {
+            san += char( '8' - src / 8 );
+        }
+        if ( isCapture ) {
+            san += 'x';
+        }
+        san += { char( 'a' + dest % 8 ), char( '8' - dest / 8 ) };
+    }
+
+    // Check is a mate if the opponent has no legal move
+    Board examineBoard = board;
+    examineBoard.makeMove( src, dest, promotedTo );
+    PieceValidMoves generator;
+    generator.generateValidMoves( examineBoard );
+    if ( examineBoard.whiteIsChecked || examineBoard.blackIsChecked ) {
+        bool hasLegalMove = false;
+        for ( SquareIndex square = 0; square < 64 && !hasLegalMove; square++ ) {
+            const auto &defender = examineBoard.squares[square];
+            if ( !defender || defender->color != examineBoard.sideToMove ) {
+                continue;
+            }
+            for ( SquareIndex target : defender->validMoves ) {
+                if ( isLegal( examineBoard, square, target, EMPTY, generator ) ) {
+                    hasLegalMove = true;
+                    break;
+                }
+            }
+        }
+        san += hasLegalMove ? '+' : '#';
+    }
+    return san;
+}
+
+/**
+ * Finds the legal move described by the standard algebraic notation.
+ * Check, mate and annotation suffixes are ignored, captures do not have to be marked.
+ * It assumes that the board has valid moves calculated.
+ *
+ * @param board position before the move.
+ * @param san move in standard algebraic notation.
+ *
+ * @return MoveContent of the move, nullopt if there is no such legal move or more than one.
+ */
+std::optional<MoveContent> MoveContent::fromPGN( const Board &board, std::string_view san ) {
+    while ( !san.empty() && std::string_view( "+#!?" ).find( san.back() ) != std::string_view::npos ) {
+        san.remove_suffix( 1 );
+    }
+
+    PieceValidMoves generator;
+    const SquareIndex kingSquare = board.kingSquares[board.sideToMove];
+    auto castling = [&]( SquareIndex dest ) -> std::optional<MoveContent> {
+        const auto &king = board.squares[kingSquare];
+        if ( kingSquare == NULL_SQUARE || !king ||
+             std::find( king->validMoves.cbegin(), king->validMoves.cend(), dest ) == king->validMoves.cend() ||
+             !isLegal( board, kingSquare, dest, EMPTY, generator ) ) {
+            return std::nullopt;
+        }
+        return MoveContent( kingSquare, dest, EMPTY, KING );
+    };
+    if ( san == "O-O" || san == "0-0" ) {
+        return castling( kingSquare + 2 );
+    }
+    if ( san == "O-O-O" || san == "0-0-0" ) {
+        return castling( kingSquare - 2 );
+    }
+
+    // Piece letter, optional source file and rank, optional capture, destination and optional promotion
+    PieceType type = PAWN;
+    if ( !san.empty() && std::string_view( "NBRQK" ).find( san.front() ) != std::string_view::npos ) {
+        type = Piece( san.front() ).type;
+        san.remove_prefix( 1 );
+    }
+    PieceType promotion = EMPTY;
+    if ( !san.empty() && std::string_view( "NBRQ" ).find( san.back() ) != std::string_view::npos ) {
+        promotion = Piece( san.back() ).type;
+        san.remove_suffix( 1 );
+        if ( !san.empty() && san.back() == '=' ) {
+            san.remove_suffix( 1 );
+        }
+    }
+    if ( san.size() < 2 || san[san.size() - 2] < 'a' || san[san.size() - 2] > 'h' || san.back() < '1' ||
+         san.back() > '8' ) {
+        return std::nullopt;
+    }
+    const SquareIndex dest = ( '8' - san.back() ) * 8 + san[san.size() - 2] - 'a';
+    san.remove_suffix( 2 );
+    if ( !san.empty() && san.back() == 'x' ) {
+        san.remove_suffix( 1 );
+    }
+
+    int file = -1, rank = -1;
+    for ( char c : san ) {
+        if ( c >= 'a' && c <= 'h' ) {
+            file = c - 'a';
+        } else if ( c >= '1' && c <= '8' ) {
+            rank = '8' - c;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    std::optional<MoveContent> move;
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        const auto &piece = board.squares[square];
+        if ( !piece || piece->color != board.sideToMove || piece->type != type || ( file >= 0 && square % 8 != file ) ||
+             ( rank >= 0 && square / 8 != rank ) ||
+             std::find( piece->validMoves.cbegin(), piece->validMoves.cend(), dest ) == piece->validMoves.cend() ||
+             isPromotion( *piece, dest ) != ( promotion != EMPTY ) ||
+             !isLegal( board, square, dest, promotion, generator ) ) {
+            continue;
+        }
+        if ( move ) {
+            return std::nullopt;  // Ambiguous
+        }
+
+        const auto &taken = board.squares[dest];
+        const bool isEnPassant = type == PAWN && !taken && square % 8 != dest % 8;
+        move = MoveContent( square, dest, promotion, type, taken ? taken->type : ( isEnPassant ? PAWN : EMPTY ),
+                            isEnPassant );
+    }
+    return move;
+}
+
+std::string MoveContent::toUCI() const {
+    if ( src == NULL_SQUARE || dest == NULL_SQUARE ) {
+        return "0000";  // Null move
+    }
+
+    std::string move = { char( 'a' + src % 8 ), char( '8' - src / 8 ), char( 'a' + dest % 8 ), char( '8' - dest / 8 ) };
+    switch ( promotion ) {
+        case QUEEN:
+            move += 'q';
+            break;
+        case ROOK:
+            move += 'r';
+            break;
+        case BISHOP:
+            move += 'b';
+            break;
+        case KNIGHT:
+            move += 'n';
+            break;
+        default:
+            break;
+    }
+    return move;
+}
 
 int MoveContent::compareMin( const MoveContent& m1, const MoveContent& m2 ) { return m1.score < m2.score; }
 int MoveContent::compareMax( const MoveContent& m1, const MoveContent& m2 ) { return m1.score > m2.score; }
@@ -1,5 +1,10 @@
 #include "Movegen.h"
 
+#include <algorithm>
+#include <cassert>
+
+#include "Trace.h"
+
 /* -------------------------------------------------------------------------- */
 /*                              Pieve Valid Moves                             */
 /* -------------------------------------------------------------------------- */
@@ -13,6 +18,14 @@ PieceValidMoves::PieceValidMoves()
 
 // Generate valid moves for every piece on the board filling Piece.validMoves vectors
 int PieceValidMoves::generateValidMoves( Board& board ) {
+    return board.sideToMove == WHITE ? generateValidMoves<WHITE>( board ) : generateValidMoves<BLACK>( board );
+}
+
+template <PieceColor Us>
+int PieceValidMoves::generateValidMoves( Board& board ) {
+    TRACE_SCOPE( "PieceValidMoves::generateValidMoves" );
+    assert( board.sideToMove == Us );
+    constexpr PieceColor Them = Us == WHITE ? BLACK : WHITE;
     int movesGeneratedCount = 0;
 
     // Reset attack boards
@@ -30,9 +43,6 @@ int PieceValidMoves::generateValidMoves( Board& board ) {
     for ( SquareIndex srcSquare = 0; srcSquare < 64; srcSquare++ ) {
         auto& piece = board.squares[srcSquare];
         if ( piece ) {
-            // TODO:
-            // manually resize to the count of previously generated moves to avoid dynamic resizing
-            // requires adding piece.lastValidMovesCount to the Piece class
             // Clear the previous valid moves
             piece->validMoves.clear();
             piece->attackedValue = 0;
@@ -45,45 +55,28 @@ int PieceValidMoves::generateValidMoves( Board& board ) {
                 continue;
             }
 
-            // Pawns behave different than other pieces so we analyze their moves separately
-            if ( piece->type == PAWN ) {
-                movesGeneratedCount += generateValidPawnMoves( board, srcSquare );
-                continue;
-            }
-
-            // For all other pieces we iterate through all the rays and each move to generate valid moves
-            for ( auto& ray : pieceMoves_.getMoveList( piece->color, piece->type, srcSquare ) ) {
-                for ( auto destSquare : ray ) {
-                    // Analyze the move to gather information about the board
-                    // Analyze move method will return true if the move is valid
-                    if ( analyzeMove( board, srcSquare, destSquare ) ) {
-                        piece->validMoves.push_back( destSquare );
-                        movesGeneratedCount++;
-                    }
-                    // We cannot continue passed a piece, so we can skip to the next ray
-                    if ( board.squares[destSquare] ) {
-                        break;
-                    }
-                }
-            }
+            // Colour is looked at once per piece, the loops over its moves are specialized
+            movesGeneratedCount += piece->color == WHITE ? generateValidPieceMoves<WHITE>( board, srcSquare )
+                                                         : generateValidPieceMoves<BLACK>( board, srcSquare );
         }
     }
 
     // Now that we have gathered information about the board we can generate the kings moves
-    if ( board.sideToMove == WHITE ) {
-        movesGeneratedCount += generateValidKingMoves( board, blackKingSquare_ );
-        movesGeneratedCount += generateValidKingMoves( board, whiteKingSquare_ );
-    } else {
-        movesGeneratedCount += generateValidKingMoves( board, whiteKingSquare_ );
-        movesGeneratedCount += generateValidKingMoves( board, blackKingSquare_ );
-    }
+    // King of the side to move goes last, so it sees the squares attacked by the enemy king
+    SquareIndex& ourKingSquare = Us == WHITE ? whiteKingSquare_ : blackKingSquare_;
+    SquareIndex& theirKingSquare = Us == WHITE ? blackKingSquare_ : whiteKingSquare_;
+    movesGeneratedCount += generateValidKingMoves<Them>( board, theirKingSquare );
+    movesGeneratedCount += generateValidKingMoves<Us>( board, ourKingSquare );
 
-    generateValidCastlingMoves( board, whiteKingSquare_ );
-    generateValidCastlingMoves( board, blackKingSquare_ );
+    generateValidCastlingMoves<WHITE>( board, whiteKingSquare_ );
+    generateValidCastlingMoves<BLACK>( board, blackKingSquare_ );
 
     return movesGeneratedCount;
 }
 
+template int PieceValidMoves::generateValidMoves<WHITE>( Board& board );
+template int PieceValidMoves::generateValidMoves<BLACK>( Board& board );
+
 bool PieceValidMoves::validateBoard( const Board& board ) const {
     if ( board.sideToMove == WHITE && board.blackIsChecked ) {
         return false;
@@ -94,13 +87,43 @@ bool PieceValidMoves::validateBoard( const Board& board ) const {
     }
 }
 
+template <PieceColor Us>
+int PieceValidMoves::generateValidPieceMoves( Board& board, SquareIndex srcSquare ) {
+    auto& piece = board.squares[srcSquare];
+
+    // Pawns behave different than other pieces so we analyze their moves separately
+    if ( piece->type == PAWN ) {
+        return generateValidPawnMoves<Us>( board, srcSquare );
+    }
+
+    // For all other pieces we iterate through all the rays and each move to generate valid moves
+    int movesGeneratedCount = 0;
+    for ( auto& ray : pieceMoves_.getMoveList( Us, piece->type, srcSquare ) ) {
+        for ( auto destSquare : ray ) {
+            // Analyze the move to gather information about the board
+            // Analyze move method will return true if the move is valid
+            if ( analyzeMove<Us>( board, srcSquare, destSquare ) ) {
+                piece->validMoves.push_back( destSquare );
+                movesGeneratedCount++;
+            }
+            // We cannot continue passed a piece, so we can skip to the next ray
+            if ( board.squares[destSquare] ) {
+                break;
+            }
+        }
+    }
+
+    return movesGeneratedCount;
+}
+
+template <PieceColor Us>
 int PieceValidMoves::generateValidPawnMoves( Board& board, SquareIndex srcSquare ) {
     int movesGeneratedCount = 0;
     auto& pawn = board.squares[srcSquare];
 
-    for ( auto& ray : pieceMoves_.getMoveList( pawn->color, PAWN, srcSquare ) ) {
+    for ( auto& ray : pieceMoves_.getMoveList( Us, PAWN, srcSquare ) ) {
         for ( auto destSquare : ray ) {
-            if ( analyzePawnMove( board, srcSquare, destSquare ) ) {
+            if ( analyzePawnMove<Us>( board, srcSquare, destSquare ) ) {
                 pawn->validMoves.push_back( destSquare );
                 movesGeneratedCount++;
             }
@@ -114,19 +137,20 @@ int PieceValidMoves::generateValidPawnMoves( Board& board, SquareIndex srcSquare
     return movesGeneratedCount;
 }
 
+template <PieceColor Us>
 int PieceValidMoves::generateValidKingMoves( Board& board, SquareIndex srcSquare ) {
     int movesGeneratedCount = 0;
     auto& king = board.squares[srcSquare];
 
     // Iterate through kings moves
-    for ( auto& ray : pieceMoves_.getMoveList( king->color, KING, srcSquare ) ) {
+    for ( auto& ray : pieceMoves_.getMoveList( Us, KING, srcSquare ) ) {
         for ( auto destSquare : ray ) {
             // Castling moves have to be generated last so skip for now
             if ( abs( destSquare - srcSquare ) == 2 ) {
                 continue;
             }
             // Normal move
-            else if ( analyzeMove( board, srcSquare, destSquare ) ) {
+            else if ( analyzeMove<Us>( board, srcSquare, destSquare ) ) {
                 king->validMoves.push_back( destSquare );
                 movesGeneratedCount++;
             }
@@ -136,59 +160,50 @@ int PieceValidMoves::generateValidKingMoves( Board& board, SquareIndex srcSquare
     return movesGeneratedCount;
 }
 
+template <PieceColor Us>
 int PieceValidMoves::generateValidCastlingMoves( Board& board, SquareIndex srcSquare ) {
+    constexpr SquareIndex kingSquare = Us == WHITE ? 60 : 4;
     int movesGeneratedCount = 0;
-    auto& king = board.squares[srcSquare];
 
-    // Black castle
-    if ( srcSquare == 4 ) {
-        // Kingside
-        if ( analyzeCastlingMove( board, srcSquare, 6 ) ) {
-            king->validMoves.push_back( 6 );
-            movesGeneratedCount++;
-        }
-        // Queenside
-        if ( analyzeCastlingMove( board, srcSquare, 2 ) ) {
-            king->validMoves.push_back( 2 );
-            movesGeneratedCount++;
-        }
+    // King has left its starting square
+    if ( srcSquare != kingSquare ) {
+        return movesGeneratedCount;
     }
 
-    // White castle
-    else if ( srcSquare == 60 ) {
-        // Kingside
-        if ( analyzeCastlingMove( board, srcSquare, 62 ) ) {
-            king->validMoves.push_back( 62 );
-            movesGeneratedCount++;
-        }
-        // Queenside
-        if ( analyzeCastlingMove( board, srcSquare, 58 ) ) {
-            king->validMoves.push_back( 58 );
-            movesGeneratedCount++;
-        }
+    auto& king = board.squares[srcSquare];
+    // Kingside
+    if ( analyzeCastlingMove<Us, true>( board ) ) {
+        king->validMoves.push_back( kingSquare + 2 );
+        movesGeneratedCount++;
+    }
+    // Queenside
+    if ( analyzeCastlingMove<Us, false>( board ) ) {
+        king->validMoves.push_back( kingSquare - 2 );
+        movesGeneratedCount++;
     }
 
     return movesGeneratedCount;
 }
 
+template <PieceColor Us>
 bool PieceValidMoves::analyzeMove( Board& board, SquareIndex src, SquareIndex dest ) {
     auto& pieceMoving = board.squares[src];
     auto& pieceAttacked = board.squares[dest];
 
     // For all other pieces than pawns we attack every field where we can move
     // Pawns are analyzed by analyzePawnMove method
-    pieceMoving->color == WHITE ? whiteAttackBoard_[dest] = true : blackAttackBoard_[dest] = true;
+    ( Us == WHITE ? whiteAttackBoard_ : blackAttackBoard_ )[dest] = true;
 
     // Destination square is occupied
     if ( pieceAttacked ) {
         // By allied piece
-        if ( pieceAttacked->color == pieceMoving->color ) {
+        if ( pieceAttacked->color == Us ) {
             pieceAttacked->defendedValue += pieceMoving->actionValue;
             return false;
         }
         // By enemy king
         else if ( pieceAttacked->type == KING ) {
-            pieceAttacked->color == WHITE ? board.whiteIsChecked = true : board.blackIsChecked = true;
+            ( Us == WHITE ? board.blackIsChecked : board.whiteIsChecked ) = true;
             return false;
         }
         // By normal enemy piece
@@ -202,107 +217,68 @@ bool PieceValidMoves::analyzeMove( Board& board, SquareIndex src, SquareIndex de
     return true;
 }
 
+template <PieceColor Us>
 bool PieceValidMoves::analyzePawnMove( Board& board, SquareIndex srcSquare, SquareIndex destSquare ) {
     auto& pawnMoving = board.squares[srcSquare];
     auto& pieceAttacked = board.squares[destSquare];
 
-    // We attack the field if the pawn moves in diagonal
-    if ( abs( destSquare - srcSquare ) % 8 != 0 ) {
-        pawnMoving->color == WHITE ? whiteAttackBoard_[destSquare] = true : blackAttackBoard_[destSquare] = true;
+    /* --------------------------- Normal forward move -------------------------- */
+    // Pawns can move forward only if the destination square is empty
+    if ( abs( destSquare - srcSquare ) % 8 == 0 ) {
+        return !pieceAttacked;
     }
 
+    // We attack the field if the pawn moves in diagonal
+    ( Us == WHITE ? whiteAttackBoard_ : blackAttackBoard_ )[destSquare] = true;
+
     /* ------------------------------- En passant ------------------------------- */
-    if ( abs( destSquare - srcSquare ) % 8 != 0 && destSquare == board.enPassantSquare ) {
+    if ( destSquare == board.enPassantSquare ) {
         return true;
     }
     /* ---------------------------- Diagonal capture ---------------------------- */
-    else if ( abs( destSquare - srcSquare ) % 8 != 0 ) {
-        // Destination square is occupied
-        if ( pieceAttacked ) {
-            // By allied piece
-            if ( pieceAttacked->color == pawnMoving->color ) {
-                pieceAttacked->defendedValue += pawnMoving->actionValue;
-                return false;
-            }
-            // By enemy king
-            else if ( pieceAttacked->type == KING ) {
-                pieceAttacked->color == WHITE ? board.whiteIsChecked = true : board.blackIsChecked = true;
-                return false;
-            }
-            // By normal enemy piece
-            else {
-                pieceAttacked->attackedValue += pawnMoving->actionValue;
-                return true;
-            }
-        }
-        // Destination square is empty - diagonal capture invalid
-        else {
+    // Destination square is occupied
+    if ( pieceAttacked ) {
+        // By allied piece
+        if ( pieceAttacked->color == Us ) {
+            pieceAttacked->defendedValue += pawnMoving->actionValue;
             return false;
         }
-    }
-    /* --------------------------- Normal forward move -------------------------- */
-    else {
-        // Pawns can move forward only if the destination square is empty
-        if ( pieceAttacked ) {
+        // By enemy king
+        else if ( pieceAttacked->type == KING ) {
+            ( Us == WHITE ? board.blackIsChecked : board.whiteIsChecked ) = true;
             return false;
         }
-        return true;
+        // By normal enemy piece
+        else {
+            pieceAttacked->attackedValue += pawnMoving->actionValue;
+            return true;
+        }
     }
-
-    throw std::logic_error( "End of analyzePawnMove method reached without returning a value!" );
+    // Destination square is empty - diagonal capture invalid
+    return false;
 }
 
-bool PieceValidMoves::analyzeCastlingMove( Board& board, SquareIndex srcSquare, SquareIndex destSquare ) {
-    auto& king = board.squares[srcSquare];
-
-    /* ------------------------- Black king side castle ------------------------- */
-    if ( srcSquare == 4 && destSquare == 6 ) {
-        // King already moved
-        if ( king->hasMoved ) return false;
-        // Rook is gone or already moved
-        if ( !board.squares[7] || board.squares[7]->type != ROOK || board.squares[7]->hasMoved ) return false;
-        // Squares between king and rook are occupied
-        if ( board.squares[5] || board.squares[6] ) return false;
-        // King passes through attacked squares
-        if ( whiteAttackBoard_[4] || whiteAttackBoard_[5] || whiteAttackBoard_[6] ) return false;
-        return true;
-    }
-    /* ------------------------- Black queen side castle ------------------------ */
-    if ( srcSquare == 4 && destSquare == 2 ) {
-        // King already moved
-        if ( king->hasMoved ) return false;
-        // Rook is gone or already moved
-        if ( !board.squares[0] || board.squares[0]->type != ROOK || board.squares[0]->hasMoved ) return false;
-        // Squares between king and rook are occupied
-        if ( board.squares[1] || board.squares[2] || board.squares[3] ) return false;
-        // King passes through attacked squares
-        if ( whiteAttackBoard_[2] || whiteAttackBoard_[3] || whiteAttackBoard_[4] ) return false;
-        return true;
-    }
-    /* ------------------------- White king side castle ------------------------- */
-    if ( srcSquare == 60 && destSquare == 62 ) {
-        // King already moved
-        if ( king->hasMoved ) return false;
-        // Rook is gone or already moved
-        if ( !board.squares[63] || board.squares[63]->type != ROOK || board.squares[63]->hasMoved ) return false;
-        // Squares between king and rook are occupied
-        if ( board.squares[61] || board.squares[62] ) return false;
-        // King passes through attacked squares
-        if ( blackAttackBoard_[60] || blackAttackBoard_[61] || blackAttackBoard_[62] ) return false;
-        return true;
+template <PieceColor Us, bool IsKingSide>
+bool PieceValidMoves::analyzeCastlingMove( const Board& board ) const {
+    constexpr SquareIndex kingSquare = Us == WHITE ? 60 : 4;
+    constexpr SquareIndex rookSquare = IsKingSide ? kingSquare + 3 : kingSquare - 4;
+    constexpr SquareIndex destSquare = IsKingSide ? kingSquare + 2 : kingSquare - 2;
+    const auto& enemyAttackBoard = Us == WHITE ? blackAttackBoard_ : whiteAttackBoard_;
+    const auto& rook = board.squares[rookSquare];
+
+    // King already moved
+    if ( board.squares[kingSquare]->hasMoved ) return false;
+    // Rook is gone or already moved
+    if ( !rook || rook->type != ROOK || rook->hasMoved ) return false;
+    // Squares between king and rook are occupied
+    for ( SquareIndex square = std::min( kingSquare, rookSquare ) + 1; square < std::max( kingSquare, rookSquare );
+          square++ ) {
+        if ( board.squares[square] ) return false;
     }
-    /* ------------------------- White queen side castle ------------------------ */
-    if ( srcSquare == 60 && destSquare == 58 ) {
-        // King already moved
-        if ( king->hasMoved ) return false;
-        // Rook is gone or already moved
-        if ( !board.squares[56] || board.squares[56]->type != ROOK || board.squares[56]->hasMoved ) return false;
-        // Squares between king and rook are occupied
-        if ( board.squares[57] || board.squares[58] || board.squares[59] ) return false;
-        // King passes through attacked squares
-        if ( blackAttackBoard_[58] || blackAttackBoard_[59] || blackAttackBoard_[60] ) return false;
-        return true;
+    // King passes through attacked squares
+    for ( SquareIndex square = std::min( kingSquare, destSquare ); square <= std::max( kingSquare, destSquare );
+          square++ ) {
+        if ( enemyAttackBoard[square] ) return false;
     }
-
-    throw std::logic_error( "Analyze castling move was called with a move that doesn't represent castling!" );
+    return true;
 }
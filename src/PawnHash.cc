@@ -0,0 +1,36 @@
+#include "PawnHash.h"
+
+#include <bit>
+#include <stdexcept>
+
+PawnHashTable::PawnHashTable( std::size_t size )
+    : entries_( size ), mask_( size - 1 ), probes_( 0 ), hits_( 0 ), used_( 0 ) {
+    if ( !std::has_single_bit( size ) ) {
+        throw std::invalid_argument( "Pawn hash table size has to be a power of two!" );
+    }
+    clear();
+}
+
+PawnEntry &PawnHashTable::probe( uint64_t key, bool &found ) {
+    PawnEntry &entry = entries_[key & mask_];
+    probes_++;
+    found = entry.key == key;
+    if ( found ) {
+        hits_++;
+    } else if ( entry.key == ~0ULL ) {
+        // Empty entry is going to be filled by the caller
+        used_++;
+    }
+    return entry;
+}
+
+void PawnHashTable::clear() {
+    // Key of the position without pawns is 0, so empty entries are marked with a key that cannot occur in practice
+    for ( auto &entry : entries_ ) {
+        entry = PawnEntry{};
+        entry.key = ~0ULL;
+    }
+    probes_ = 0;
+    hits_ = 0;
+    used_ = 0;
+}
@@ -0,0 +1,166 @@
+#include "PerfCounters.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+static const char *const PERF_EVENT_NAMES[PERF_EVENTS] = { "cycles", "instructions", "branch-misses",
+                                                           "L1d-read-misses", "LLC-read-misses" };
+
+/* -------------------------------- Readings -------------------------------- */
+
+double PerfReading::ipc() const {
+    if ( !available[PERF_CYCLES] || !available[PERF_INSTRUCTIONS] || values[PERF_CYCLES] == 0 ) {
+        return 0.0;
+    }
+    return double( values[PERF_INSTRUCTIONS] ) / values[PERF_CYCLES];
+}
+
+bool PerfReading::isAvailable() const {
+    for ( bool isEventAvailable : available ) {
+        if ( isEventAvailable ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* -------------------------------- Counters -------------------------------- */
+
+#ifdef __linux__
+
+// Event configuration of perf_event_attr indexed by PerfEvent
+static perf_event_attr eventAttributes( PerfEvent event ) {
+    perf_event_attr attributes;
+    std::memset( &attributes, 0, sizeof( attributes ) );
+    attributes.size = sizeof( attributes );
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const uint64_t cacheMiss = ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+    switch ( event ) {
+        case PERF_CYCLES:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_BRANCH_MISSES:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PERF_L1D_MISSES:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = PERF_COUNT_HW_CACHE_L1D | cacheMiss;
+            break;
+        case PERF_LLC_MISSES:
+            // Generic PERF_COUNT_HW_CACHE_MISSES may count other caches depending on the CPU
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = PERF_COUNT_HW_CACHE_LL | cacheMiss;
+            break;
+        default:
+            break;
+    }
+    return attributes;
+}
+
+PerfCounters::PerfCounters() {
+    for ( int event = 0; event < PERF_EVENTS; event++ ) {
+        perf_event_attr attributes = eventAttributes( PerfEvent( event ) );
+        // Calling thread on any CPU, -1 if the event cannot be opened
+        descriptors_[event] = syscall( SYS_perf_event_open, &attributes, 0, -1, -1, 0 );
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for ( int descriptor : descriptors_ ) {
+        if ( descriptor >= 0 ) {
+            close( descriptor );
+        }
+    }
+}
+
+void PerfCounters::start() {
+    for ( int descriptor : descriptors_ ) {
+        if ( descriptor >= 0 ) {
+            ioctl( descriptor, PERF_EVENT_IOC_RESET, 0 );
+            ioctl( descriptor, PERF_EVENT_IOC_ENABLE, 0 );
+        }
+    }
+}
+
+PerfReading PerfCounters::stop() {
+    PerfReading reading;
+    for ( int event = 0; event < PERF_EVENTS; event++ ) {
+        if ( descriptors_[event] >= 0 ) {
+            ioctl( descriptors_[event], PERF_EVENT_IOC_DISABLE, 0 );
+        }
+    }
+    for ( int event = 0; event < PERF_EVENTS; event++ ) {
+        uint64_t values[3];  // Count, time enabled and time running
+        if ( descriptors_[event] < 0 || read( descriptors_[event], values, sizeof( values ) ) != sizeof( values ) ||
+             values[2] == 0 ) {
+            continue;
+        }
+        reading.values[event] = values[2] < values[1] ? uint64_t( double( values[0] ) * values[1] / values[2] )
+                                                       : values[0];
+        reading.available[event] = true;
+    }
+    return reading;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    descriptors_.fill( -1 );
+}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+PerfReading PerfCounters::stop() {
+    return PerfReading();
+}
+
+#endif
+
+bool PerfCounters::isAvailable() const {
+    for ( int descriptor : descriptors_ ) {
+        if ( descriptor >= 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* --------------------------------- Output --------------------------------- */
+
+void PerfCounters::printReport( const PerfReading &reading, uint64_t nodes, std::ostream &out ) {
+    if ( !reading.isAvailable() ) {
+        out << "Hardware counters unavailable" << std::endl;
+        return;
+    }
+    out << std::fixed << std::setprecision( 2 );
+    for ( int event = 0; event < PERF_EVENTS; event++ ) {
+        out << PERF_EVENT_NAMES[event] << " ";
+        if ( reading.available[event] ) {
+            out << double( reading.values[event] ) / std::max<uint64_t>( nodes, 1 ) << "/node, ";
+        } else {
+            out << "unavailable, ";
+        }
+    }
+    out << "IPC " << reading.ipc() << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,170 @@
+#include "Perft.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+// Depths are chosen so that every position takes a noticeable but short time
+static const std::vector<PerftPosition> PERFT_POSITIONS = {
+    { "startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197281 },
+    { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862 },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624 },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333 },
+    { "position4-mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 4, 422333 },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379 },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890 },
+    { "promotion", "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1", 4, 182838 },
+    { "promotion-out-of-check", "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 5, 266199 },
+    { "promotion-giving-check", "4k3/1P6/8/8/8/8/K7/8 w - - 0 1", 6, 217342 },
+    { "underpromotion", "8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6, 92683 },
+    { "en-passant-pinned", "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467 },
+    { "en-passant-discovered-check", "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6, 1015133 },
+    { "en-passant-check-evasion", "8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1", 6, 824064 },
+    { "castling-kingside", "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072 },
+    { "castling-queenside", "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", 6, 803711 },
+    { "castling-through-attack", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206 },
+    { "castling-rights-lost", "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", 4, 1720476 },
+};
+
+/* --------------------------------- Counting ------------------------------- */
+
+uint64_t Perft::count( Board &board, int depth, PieceValidMoves &generator ) {
+    if ( depth == 0 ) {
+        return 1;
+    }
+
+    uint64_t nodes = 0;
+    const Board currentBoard( board );
+    auto countMove = [&]( SquareIndex src, SquareIndex dest, PieceType promotion ) {
+        board.makeMove( src, dest, promotion );
+        generator.generateValidMoves( board );
+        // Pseudo legal moves leaving the king in check are not counted
+        if ( generator.validateBoard( board ) ) {
+            nodes += count( board, depth - 1, generator );
+        }
+        board = currentBoard;
+    };
+
+    for ( SquareIndex src = 0; src < 64; src++ ) {
+        const auto &piece = currentBoard.squares[src];
+        if ( piece == std::nullopt || piece->color != currentBoard.sideToMove ) {
+            continue;
+        }
+        for ( SquareIndex dest : piece->validMoves ) {
+            if ( piece->type == PAWN && ( dest < 8 || dest > 55 ) ) {
+                for ( PieceType promotion : { KNIGHT, BISHOP, ROOK, QUEEN } ) {
+                    countMove( src, dest, promotion );
+                }
+            } else {
+                countMove( src, dest, EMPTY );
+            }
+        }
+    }
+    return nodes;
+}
+
+const std::vector<PerftPosition> &Perft::positions() {
+    return PERFT_POSITIONS;
+}
+
+/**
+ * Counts the nodes of every position and measures the nodes per second.
+ *
+ * @param positions positions with their depths and expected node counts.
+ *
+ * @return PerftReport with a result per position.
+ */
+PerftReport Perft::run( const std::vector<PerftPosition> &positions ) {
+    PerftReport report{ {}, 0, 0, 0, 0 };
+    PieceValidMoves generator;
+    for ( const auto &position : positions ) {
+        Board board( position.fen );
+        generator.generateValidMoves( board );
+
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t nodes = count( board, position.depth, generator );
+        const int64_t time =
+            std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count();
+
+        const uint64_t nps = nodes * 1000000 / std::max<int64_t>( time, 1 );
+        report.results.push_back( { position.name, position.depth, nodes, position.expected, time, nps } );
+        report.failed += nodes != position.expected;
+        report.nodes += nodes;
+        report.time += time;
+    }
+    report.nps = report.nodes * 1000000 / std::max<int64_t>( report.time, 1 );
+    return report;
+}
+
+/* ---------------------------------- Files --------------------------------- */
+
+void Perft::writeJson( const PerftReport &report, std::ostream &out ) {
+    out << "{\n  \"nodes\": " << report.nodes << ",\n  \"time\": " << report.time << ",\n  \"nps\": " << report.nps
+        << ",\n  \"results\": [\n";
+    for ( std::size_t i = 0; i < report.results.size(); i++ ) {
+        const PerftResult &result = report.results[i];
+        out << "    { \"name\": \"" << result.name << "\", \"depth\": " << result.depth
+            << ", \"nodes\": " << result.nodes << ", \"expected\": " << result.expected
+            << ", \"time\": " << result.time << ", \"nps\": " << result.nps << " }"
+            << ( i + 1 < report.results.size() ? ",\n" : "\n" );
+    }
+    out << "  ]\n}" << std::endl;
+}
+
+std::map<std::string, uint64_t> Perft::readBaseline( std::istream &in ) {
+    std::map<std::string, uint64_t> baseline;
+    std::string line;
+    while ( std::getline( in, line ) ) {
+        const auto name = line.find( "\"name\": \"" );
+        if ( name == std::string::npos ) {
+            continue;
+        }
+        const auto nameStart = name + 9;
+        const auto nameEnd = line.find( '"', nameStart );
+        const auto nps = line.find( "\"nps\": " );
+        if ( nameEnd == std::string::npos || nps == std::string::npos ) {
+            throw std::invalid_argument( "Invalid perft baseline - " + line );
+        }
+        baseline[line.substr( nameStart, nameEnd - nameStart )] = std::stoull( line.substr( nps + 7 ) );
+    }
+    return baseline;
+}
+
+/**
+ * Compares nodes per second of every position with the baseline, positions missing in the baseline are skipped.
+ *
+ * @param report current results.
+ * @param baseline nodes per second by position name.
+ * @param threshold largest allowed slowdown, percent.
+ *
+ * @return positions slower than the baseline by more than the threshold.
+ */
+std::vector<PerftRegression> Perft::compare( const PerftReport &report,
+                                             const std::map<std::string, uint64_t> &baseline, double threshold ) {
+    std::vector<PerftRegression> regressions;
+    for ( const auto &result : report.results ) {
+        const auto entry = baseline.find( result.name );
+        if ( entry == baseline.end() || entry->second == 0 ) {
+            continue;
+        }
+        const double change = 100.0 * ( double( result.nps ) - double( entry->second ) ) / entry->second;
+        if ( change < -threshold ) {
+            regressions.push_back( { result.name, entry->second, result.nps, change } );
+        }
+    }
+    return regressions;
+}
+
+/* --------------------------------- Output --------------------------------- */
+
+void Perft::printReport( const PerftReport &report, std::ostream &out ) {
+    for ( const auto &result : report.results ) {
+        out << std::left << std::setw( 30 ) << result.name << std::right << " depth " << result.depth
+            << std::setw( 10 ) << result.nodes << ( result.nodes == result.expected ? " ok    " : " WRONG " )
+            << std::setw( 8 ) << result.time / 1000 << " ms " << std::setw( 10 ) << result.nps << " nps\n";
+    }
+    out << "Failed " << report.failed << " of " << report.results.size() << " positions, " << report.nodes
+        << " nodes in " << report.time / 1000 << " ms, " << report.nps << " nps" << std::endl;
+}
@@ -0,0 +1,171 @@
+#include "Pgn.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Movegen.h"
+
+/* --------------------------------- PgnGame -------------------------------- */
+
+std::string_view PgnGame::tag( std::string_view name ) const {
+    const auto it = std::find_if( tags.cbegin(), tags.cend(), [&]( const auto &tag ) { return tag.first == name; } );
+    return it != tags.cend() ? it->second : std::string_view();
+}
+
+Board PgnGame::startingBoard() const {
+    const std::string_view fen = tag( "FEN" );
+    Board board = fen.empty() ? Board() : Board( fen );
+    PieceValidMoves generator;
+    generator.generateValidMoves( board );
+    return board;
+}
+
+void PgnGame::clear() {
+    tags.clear();
+    moves.clear();
+    result = std::string_view();
+}
+
+/* -------------------------------- PgnReader ------------------------------- */
+
+PgnReader::PgnReader( std::istream &in, std::size_t chunkSize )
+    : in_( in ), buffer_( std::max<std::size_t>( chunkSize, 1 ) ), begin_( 0 ), end_( 0 ), isEndOfInput_( false ) {}
+
+bool PgnReader::next( PgnGame &game ) {
+    while ( true ) {
+        game.clear();
+        const std::string_view text( buffer_.data() + begin_, end_ - begin_ );
+        if ( const auto length = parseGame( text, game ) ) {
+            begin_ += *length;
+            return true;
+        }
+        if ( isEndOfInput_ ) {
+            begin_ = end_;
+            return false;
+        }
+        // Game is parsed again from its start, after the buffer has been refilled
+        readChunk();
+    }
+}
+
+// Moves the unread data to the front of the buffer and appends the next chunk, the buffer grows if it is full
+void PgnReader::readChunk() {
+    std::memmove( buffer_.data(), buffer_.data() + begin_, end_ - begin_ );
+    end_ -= begin_;
+    begin_ = 0;
+    if ( end_ == buffer_.size() ) {
+        buffer_.resize( buffer_.size() * 2 );
+    }
+
+    in_.read( buffer_.data() + end_, buffer_.size() - end_ );
+    end_ += in_.gcount();
+    isEndOfInput_ = !in_;
+}
+
+/**
+ * Parses a single game from the beginning of the text.
+ * Game ends with a result token, with a tag following the moves or with the end of the input.
+ *
+ * @param text buffered input, the game starts at its beginning.
+ * @param game game to fill, views point into the text.
+ *
+ * @return number of bytes parsed, nullopt if the text ends before the game does and more input is available,
+ * also nullopt if there is no game left in the input.
+ */
+std::optional<std::size_t> PgnReader::parseGame( std::string_view text, PgnGame &game ) const {
+    std::size_t pos = 0;
+    auto isSpace = []( char c ) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; };
+    auto find = [&]( char c, std::size_t from ) { return text.find( c, from ); };
+
+    while ( true ) {
+        while ( pos < text.size() && isSpace( text[pos] ) ) {
+            pos++;
+        }
+        if ( pos == text.size() ) {
+            const bool hasGame = !game.tags.empty() || !game.moves.empty();
+            return isEndOfInput_ && hasGame ? std::optional<std::size_t>( pos ) : std::nullopt;
+        }
+
+        const char c = text[pos];
+        if ( c == '[' ) {
+            // Tag after the moves starts the next game, which had no result
+            if ( !game.moves.empty() ) {
+                return pos;
+            }
+            const std::size_t nameEnd = text.find_first_of( " ]", pos );
+            const std::size_t valueBegin = find( '"', pos );
+            std::size_t valueEnd = valueBegin == std::string_view::npos ? valueBegin : find( '"', valueBegin + 1 );
+            while ( valueEnd != std::string_view::npos && text[valueEnd - 1] == '\\' ) {
+                valueEnd = find( '"', valueEnd + 1 );
+            }
+            const std::size_t tagEnd = valueEnd == std::string_view::npos ? valueEnd : find( ']', valueEnd );
+            if ( tagEnd == std::string_view::npos ) {
+                return std::nullopt;
+            }
+            game.tags.emplace_back( text.substr( pos + 1, nameEnd - pos - 1 ),
+                                    text.substr( valueBegin + 1, valueEnd - valueBegin - 1 ) );
+            pos = tagEnd + 1;
+        } else if ( c == '{' || c == ';' || c == '%' ) {
+            // Comments and escaped lines
+            const std::size_t commentEnd = find( c == '{' ? '}' : '\n', pos );
+            if ( commentEnd != std::string_view::npos ) {
+                pos = commentEnd + 1;
+            } else if ( isEndOfInput_ && c != '{' ) {
+                pos = text.size();
+            } else {
+                return std::nullopt;
+            }
+        } else if ( c == '(' ) {
+            // Variations can be nested and contain comments with parentheses
+            int depth = 0;
+            do {
+                if ( pos == text.size() ) {
+                    return std::nullopt;
+                }
+                if ( text[pos] == '{' ) {
+                    pos = find( '}', pos );
+                    if ( pos == std::string_view::npos ) {
+                        return std::nullopt;
+                    }
+                }
+                depth += text[pos] == '(' ? 1 : text[pos] == ')' ? -1 : 0;
+                pos++;
+            } while ( depth > 0 );
+        } else {
+            // Symbol continues until a whitespace or a delimiter, it can be cut by the end of the buffer
+            std::size_t symbolEnd = pos;
+            while ( symbolEnd < text.size() && !isSpace( text[symbolEnd] ) &&
+                    std::string_view( "{}()[];" ).find( text[symbolEnd] ) == std::string_view::npos ) {
+                symbolEnd++;
+            }
+            if ( symbolEnd == text.size() && !isEndOfInput_ ) {
+                return std::nullopt;
+            }
+            std::string_view symbol = text.substr( pos, symbolEnd - pos );
+            pos = std::max( symbolEnd, pos + 1 );
+            if ( symbol.empty() ) {
+                continue;  // Stray delimiter
+            }
+
+            if ( symbol == "1-0" || symbol == "0-1" || symbol == "1/2-1/2" || symbol == "*" ) {
+                game.result = symbol;
+                return pos;
+            }
+            // Numeric annotation glyphs and move numbers (12. or 12... or glued 12.e4), 0-0 is castling
+            if ( symbol.front() == '$' ) {
+                continue;
+            }
+            if ( symbol.front() >= '0' && symbol.front() <= '9' ) {
+                const std::size_t lastDot = symbol.find_last_of( '.' );
+                if ( lastDot != std::string_view::npos ) {
+                    symbol.remove_prefix( lastDot + 1 );
+                } else if ( symbol.find_first_not_of( "0123456789" ) == std::string_view::npos ) {
+                    continue;
+                }
+            }
+            if ( !symbol.empty() ) {
+                game.moves.push_back( symbol );
+            }
+        }
+    }
+}
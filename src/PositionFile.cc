@@ -0,0 +1,62 @@
+#include "PositionFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+/* ------------------------------ PositionFile ------------------------------ */
+
+PositionFile::PositionFile( const std::string &path ) : positions_( nullptr ), size_( 0 ) {
+    const int fd = open( path.c_str(), O_RDONLY );
+    if ( fd < 0 ) {
+        throw std::runtime_error( "Cannot open position file " + path );
+    }
+
+    struct stat status;
+    if ( fstat( fd, &status ) < 0 || status.st_size % sizeof( PackedPosition ) != 0 ) {
+        close( fd );
+        throw std::runtime_error( "Invalid position file " + path );
+    }
+    size_ = status.st_size / sizeof( PackedPosition );
+
+    // Mapping stays valid after closing the file descriptor
+    if ( size_ > 0 ) {
+        void *data = mmap( nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+        if ( data == MAP_FAILED ) {
+            close( fd );
+            throw std::runtime_error( "Cannot map position file " + path );
+        }
+        positions_ = static_cast<const PackedPosition *>( data );
+    }
+    close( fd );
+}
+
+PositionFile::~PositionFile() {
+    if ( positions_ != nullptr ) {
+        munmap( const_cast<PackedPosition *>( positions_ ), size_ * sizeof( PackedPosition ) );
+    }
+}
+
+/* ----------------------------- PositionWriter ----------------------------- */
+
+PositionWriter::PositionWriter( const std::string &path, bool append )
+    : path_( path ), out_( path, std::ios::binary | ( append ? std::ios::app : std::ios::trunc ) ) {
+    if ( !out_ ) {
+        throw std::runtime_error( "Cannot open position file " + path );
+    }
+}
+
+void PositionWriter::write( const PackedPosition &position ) {
+    if ( !out_.write( reinterpret_cast<const char *>( &position ), sizeof( position ) ) ) {
+        throw std::runtime_error( "Cannot write position file " + path_ );
+    }
+}
+
+void PositionWriter::flush() {
+    if ( !out_.flush() ) {
+        throw std::runtime_error( "Cannot write position file " + path_ );
+    }
+}
@@ -1,125 +1,601 @@
 #include <algorithm>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <thread>
 
 #include "Search.h"
 
+#include "Bitbase.h"
+#include "Material.h"
+#include "Trace.h"
+
+static int64_t elapsedSince( std::chrono::steady_clock::time_point start ) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+}
+
 /**
- * Returns the best possible move for the current player.
+ * Returns the best possible move for the side to move of the board.
  * It assumes that the board has valid moves calculated and the game is not over yet!
  *
  * @param board position to examine.
  * @param maxDepth maximum depth of search.
- * @param maximizingPlayer true if the current player is WHITE, false if BLACK.
+ * @param stats optional statistics of the search.
  *
  * @return MoveContent representing the best move for the current player.
  */
-MoveContent Search::getBestMove( const Board& examineBoard, int maxDepth, bool maximizingPlayer, int nodesExamined,
-                                 int nodesEvaluated, int nodesPruned ) const {
+MoveContent Search::getBestMove( const Board& examineBoard, int maxDepth, SearchStats* stats ) {
+    const bool isWhiteToMove = examineBoard.sideToMove == WHITE;
+
+    // Tables are generated on the first use, so the search below does not allocate
+    MaterialTable::getInstance();
+    Bitbase::getInstance();
+
+    const PawnHashTable& pawnHashTable = Evaluation::getPawnHashTable();
+    const uint64_t pawnHashProbes = pawnHashTable.probes(), pawnHashHits = pawnHashTable.hits();
+    SearchStats searchStats;
+
     MoveContent bestMove;
-    bestMove.score = maximizingPlayer ? NEGATIVE_INFINITY : POSITIVE_INFINITY;
-    std::vector<MoveContent> possibleMoves = getPossibleMoves( examineBoard );
-    auto compare = maximizingPlayer ? MoveContent::compareMax : MoveContent::compareMin;
+    bestMove.score = isWhiteToMove ? NEGATIVE_INFINITY : POSITIVE_INFINITY;
+    MoveList& possibleMoves = plies_[0].moves;
+    getPossibleMoves( examineBoard, possibleMoves );
+    auto compare = isWhiteToMove ? MoveContent::compareMax : MoveContent::compareMin;
 
-    // Perform iterative deepening search
-    for ( int depth = 1; depth <= maxDepth; depth++ ) {
+    // Perform iterative deepening search, root moves are searched to the full depth
+    for ( int depth = 1; depth <= std::min( maxDepth, MAX_SEARCH_DEPTH ); depth++ ) {
+        TRACE_SCOPE( "Search::iteration" );
         std::sort( possibleMoves.begin(), possibleMoves.end(), compare );
+        const uint64_t iterationNodes = searchStats.nodes;
+        const auto iterationStart = std::chrono::steady_clock::now();
 
         for ( auto move : possibleMoves ) {
-            Board board = examineBoard;
+            Board& board = plies_[1].board;
+            board = examineBoard;
             board.makeMove( move.src, move.dest, move.promotion );
             generator.generateValidMoves( board );
             if ( !generator.validateBoard( board ) ) {
                 continue;
             }
 
-            move.score = alphaBeta( board, depth, NEGATIVE_INFINITY, POSITIVE_INFINITY, !maximizingPlayer,
-                                    nodesExamined, nodesEvaluated, nodesPruned );
+            move.score =
+                isWhiteToMove
+                    ? alphaBeta<BLACK>( board, 1, depth, NEGATIVE_INFINITY, POSITIVE_INFINITY, searchStats )
+                    : alphaBeta<WHITE>( board, 1, depth, NEGATIVE_INFINITY, POSITIVE_INFINITY, searchStats );
 
-            if ( ( maximizingPlayer && move.score > bestMove.score ) ||
-                 ( !maximizingPlayer && move.score < bestMove.score ) ) {
+            if ( ( isWhiteToMove && move.score > bestMove.score ) ||
+                 ( !isWhiteToMove && move.score < bestMove.score ) ) {
                 bestMove = move;
             }
         }
+        // Iterations are only recorded on request, the search itself does not allocate
+        if ( stats != nullptr ) {
+            searchStats.iterations.push_back(
+                { depth, searchStats.nodes - iterationNodes, elapsedSince( iterationStart ) } );
+        }
         // TODO: Should be possible to terminate the search at any given time
         // if ( timeIsUp() ) {
         //     break;
         // }
     }
+
+    if ( stats != nullptr ) {
+        searchStats.pawnHashProbes = pawnHashTable.probes() - pawnHashProbes;
+        searchStats.pawnHashHits = pawnHashTable.hits() - pawnHashHits;
+        searchStats.pawnHashUsage = pawnHashTable.usage();
+        *stats = std::move( searchStats );
+    }
     return bestMove;
 }
 
+/* -------------------------------------------------------------------------- */
+/*                          Limited iterative deepening                       */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Searches the position with increasing depth until the limits are reached or the search is stopped.
+ * It assumes that the board has valid moves calculated and the game is not over yet!
+ *
+ * @param examineBoard position to examine.
+ * @param limits depth, node and time limits of the search.
+ * @param stop stop request flag, can be set from another thread and is also set when the limits are reached.
+ * @param onInfo optional callback receiving the search progress.
+ * @param stats optional statistics of the search.
+ *
+ * @return MoveContent representing the best move for the side to move with its score.
+ */
+MoveContent Search::search( const Board& examineBoard, const SearchLimits& limits, std::atomic<bool>& stop,
+                            const SearchCallback& onInfo, SearchStats* stats ) {
+    const auto lines = searchLines( examineBoard, limits, stop, onInfo, stats );
+    if ( lines.empty() ) {
+        return MoveContent();
+    }
+
+    MoveContent bestMove = lines.front().pv.front();
+    bestMove.score = lines.front().score;
+    return bestMove;
+}
+
+/**
+ * Searches the position with increasing depth and returns limits.multiPv best lines with exact scores.
+ * Root moves of every iteration are shared between the search threads, each thread searching whole subtrees.
+ * Only completed iterations are used, so the result of the last completed iteration is returned after the stop.
+ * It assumes that the board has valid moves calculated and the game is not over yet!
+ *
+ * @param examineBoard position to examine.
+ * @param limits depth, node and time limits of the search and the number of lines.
+ * @param stop stop request flag, can be set from another thread and is also set when the limits are reached.
+ * @param onInfo optional callback receiving the search progress.
+ * @param stats optional statistics of the search, summed over all threads.
+ *
+ * @return lines ranked from the best, empty if there is no legal move.
+ */
+std::vector<PvLine> Search::searchLines( const Board& examineBoard, const SearchLimits& limits,
+                                         std::atomic<bool>& stop, const SearchCallback& onInfo,
+                                         SearchStats* stats ) {
+    // Tables are generated on the first use, which must not count against the time limit
+    MaterialTable::getInstance();
+    Bitbase::getInstance();
+
+    SearchControl control;
+    control.stop = &stop;
+    control.nodes = 0;
+    control.nodeLimit = limits.nodes;
+    control.start = control.lastInfo = std::chrono::steady_clock::now();
+    control.onInfo = onInfo ? &onInfo : nullptr;
+    control.depth = 0;
+
+    // Movetime is used as is, clock time is divided between the remaining moves
+    const PieceColor us = examineBoard.sideToMove;
+    int timeLimit = 0;
+    if ( limits.moveTime > 0 ) {
+        timeLimit = limits.moveTime;
+    } else if ( limits.time[us] > 0 && !limits.infinite ) {
+        const int movesToGo = limits.movesToGo > 0 ? limits.movesToGo : MOVES_TO_GO_ESTIMATE;
+        timeLimit = limits.time[us] / movesToGo + limits.increment[us] * 3 / 4;
+        timeLimit = std::max( 1, std::min( timeLimit, limits.time[us] - MOVE_OVERHEAD ) );
+    }
+    control.hasDeadline = timeLimit > 0;
+    control.pondering = &pondering_;
+    control.deadline = control.start + std::chrono::milliseconds( timeLimit );
+
+    control_ = &control;
+    reportsProgress_ = true;
+
+    // Only legal root moves are searched
+    std::vector<MoveContent> rootMoves;
+    for ( const auto& move : getPossibleMoves( examineBoard ) ) {
+        Board board = examineBoard;
+        board.makeMove( move.src, move.dest, move.promotion );
+        generator.generateValidMoves( board );
+        if ( generator.validateBoard( board ) ) {
+            rootMoves.push_back( move );
+        }
+    }
+    if ( rootMoves.empty() ) {
+        control_ = nullptr;
+        reportsProgress_ = false;
+        if ( stats != nullptr ) {
+            *stats = SearchStats();
+        }
+        return {};
+    }
+
+    const bool maximizingPlayer = us == WHITE;
+    const int worstScore = maximizingPlayer ? NEGATIVE_INFINITY : POSITIVE_INFINITY;
+    const std::size_t multiPv = std::clamp<std::size_t>( limits.multiPv, 1, rootMoves.size() );
+    auto compare = maximizingPlayer ? MoveContent::compareMax : MoveContent::compareMin;
+    std::sort( rootMoves.begin(), rootMoves.end(), compare );
+    control.bestMove = rootMoves.front();
+    std::vector<PvLine> result;
+
+    // Helper threads search with their own Search objects, which share the control of this search
+    for ( const auto& helper : helpers_ ) {
+        helper->control_ = &control;
+    }
+    std::vector<SearchStats> threadStats( threads_ );
+    std::vector<SearchIteration> iterations;
+
+    for ( int depth = 1; depth <= std::min( limits.depth, MAX_SEARCH_DEPTH ); depth++ ) {
+        TRACE_SCOPE( "Search::iteration" );
+        control.depth = depth;
+        const uint64_t iterationNodes = control.nodes;
+        const int64_t iterationStart = elapsed();
+        std::atomic<std::size_t> nextMove = 0;
+        std::mutex bestMutex;
+        std::vector<int> bestScores;  // Best multiPv exact scores found so far, from the best
+        std::vector<int> scores( rootMoves.size(), worstScore );
+        std::vector<bool> isExact( rootMoves.size(), false );
+        std::vector<PvList> lines( rootMoves.size() );
+
+        const ThreadTask searchRootMoves = [&]( Search& searcher, std::size_t thread ) {
+            SearchStats& stats = threadStats[thread];
+            const PawnHashTable& pawnHashTable = Evaluation::getPawnHashTable();
+            const uint64_t pawnHashProbes = pawnHashTable.probes(), pawnHashHits = pawnHashTable.hits();
+            for ( std::size_t i = nextMove++; i < rootMoves.size(); i = nextMove++ ) {
+                TRACE_SCOPE( "Search::rootMove" );
+                const MoveContent& move = rootMoves[i];
+                Board& board = searcher.plies_[1].board;
+                board = examineBoard;
+                board.makeMove( move.src, move.dest, move.promotion );
+                searcher.generator.generateValidMoves( board );
+
+                // Window is narrowed by the multiPv-th best score, worse moves do not need exact scores
+                int bound = worstScore;
+                {
+                    std::lock_guard<std::mutex> lock( bestMutex );
+                    if ( bestScores.size() == multiPv ) {
+                        bound = bestScores.back();
+                    }
+                }
+                const int alpha = maximizingPlayer ? bound : NEGATIVE_INFINITY;
+                const int beta = maximizingPlayer ? POSITIVE_INFINITY : bound;
+                const uint64_t nodes = stats.nodes;
+                PvList& line = searcher.plies_[1].pv;
+                const int score = maximizingPlayer
+                                      ? searcher.alphaBeta<BLACK>( board, 1, depth - 1, alpha, beta, stats, &line )
+                                      : searcher.alphaBeta<WHITE>( board, 1, depth - 1, alpha, beta, stats, &line );
+                // Limit checks have added the nodes up to the last multiple of NODES_BETWEEN_CHECKS, the difference
+                // of the remainders can be negative and is added in the modular arithmetic of uint64_t
+                control.nodes += stats.nodes % NODES_BETWEEN_CHECKS - nodes % NODES_BETWEEN_CHECKS;
+                if ( stop ) {
+                    break;
+                }
+
+                std::lock_guard<std::mutex> lock( bestMutex );
+                scores[i] = score;
+                lines[i] = line;
+                if ( maximizingPlayer ? score > bound : score < bound ) {
+                    isExact[i] = true;
+                    const auto position = std::find_if( bestScores.begin(), bestScores.end(), [&]( int best ) {
+                        return maximizingPlayer ? score > best : score < best;
+                    } );
+                    bestScores.insert( position, score );
+                    if ( bestScores.size() > multiPv ) {
+                        bestScores.pop_back();
+                    }
+                }
+            }
+            stats.pawnHashProbes += pawnHashTable.probes() - pawnHashProbes;
+            stats.pawnHashHits += pawnHashTable.hits() - pawnHashHits;
+            stats.pawnHashUsage = pawnHashTable.usage();
+        };
+
+        runOnAllThreads( searchRootMoves );
+
+        // Interrupted iteration is not trusted
+        if ( stop ) {
+            break;
+        }
+
+        // Moves are ranked by their scores, exact scores go before bounds equal to them
+        std::vector<std::size_t> ranking( rootMoves.size() );
+        std::iota( ranking.begin(), ranking.end(), 0 );
+        std::stable_sort( ranking.begin(), ranking.end(), [&]( std::size_t a, std::size_t b ) {
+            if ( scores[a] != scores[b] ) {
+                return maximizingPlayer ? scores[a] > scores[b] : scores[a] < scores[b];
+            }
+            return isExact[a] && !isExact[b];
+        } );
+
+        // Next iteration searches the moves in the order of this iteration's ranking
+        std::vector<MoveContent> rankedMoves;
+        result.clear();
+        for ( std::size_t i : ranking ) {
+            rankedMoves.push_back( rootMoves[i] );
+            rankedMoves.back().score = scores[i];
+            if ( result.size() < multiPv ) {
+                PvList pv;
+                updatePv( pv, rankedMoves.back(), lines[i] );
+                result.push_back( { scores[i], { pv.cbegin(), pv.cend() } } );
+            }
+        }
+        rootMoves = std::move( rankedMoves );
+
+        const int bestScore = result.front().score;
+        control.bestMove = rootMoves.front();
+        control.pv = result.front().pv;
+        control.lines = result;
+        iterations.push_back( { depth, control.nodes - iterationNodes, elapsed() - iterationStart } );
+
+        if ( onInfo ) {
+            onInfo( makeInfo( bestScore, control.nodes, true ) );
+        }
+
+        // Mate found or not enough time to complete another iteration
+        if ( multiPv == 1 && ( bestScore == POSITIVE_INFINITY || bestScore == NEGATIVE_INFINITY ) ) {
+            break;
+        }
+        if ( control.hasDeadline && !pondering_ && elapsed() * 2 > timeLimit ) {
+            break;
+        }
+        if ( control.nodeLimit > 0 && control.nodes >= control.nodeLimit ) {
+            break;
+        }
+    }
+
+    // Search stopped before the first iteration completed
+    if ( result.empty() ) {
+        result.push_back( { control.bestMove.score, { control.bestMove } } );
+    }
+
+    if ( stats != nullptr ) {
+        *stats = SearchStats();
+        for ( const auto& threadStat : threadStats ) {
+            *stats += threadStat;
+            stats->pawnHashUsage += threadStat.pawnHashUsage / threadStats.size();
+        }
+        stats->iterations = std::move( iterations );
+    }
+
+    for ( const auto& helper : helpers_ ) {
+        helper->control_ = nullptr;
+    }
+    control_ = nullptr;
+    reportsProgress_ = false;
+    return result;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Helper threads                               */
+/* -------------------------------------------------------------------------- */
+
+Search::~Search() { stopHelpers(); }
+
+void Search::setThreads( int threads ) {
+    threads = std::max( threads, 1 );
+    if ( threads == threads_ ) {
+        return;
+    }
+
+    stopHelpers();
+    threads_ = threads;
+    for ( int i = 1; i < threads_; i++ ) {
+        helpers_.push_back( std::make_unique<Search>() );
+    }
+    // Threads are told the current generation, so a task given before a thread starts waiting is not missed
+    for ( std::size_t i = 0; i < helpers_.size(); i++ ) {
+        helperThreads_.emplace_back( &Search::helperLoop, this, i, helpersGeneration_ );
+    }
+}
+
+// Runs the task on the calling thread and on all helper threads, returns when every thread has finished it
+void Search::runOnAllThreads( const ThreadTask& task ) {
+    {
+        std::lock_guard<std::mutex> lock( helpersMutex_ );
+        helpersTask_ = &task;
+        helpersRunning_ = helpers_.size();
+        helpersGeneration_++;
+    }
+    helpersStart_.notify_all();
+
+    task( *this, 0 );
+
+    std::unique_lock<std::mutex> lock( helpersMutex_ );
+    helpersDone_.wait( lock, [this] { return helpersRunning_ == 0; } );
+    helpersTask_ = nullptr;
+}
+
+void Search::helperLoop( std::size_t index, uint64_t generation ) {
+    std::unique_lock<std::mutex> lock( helpersMutex_ );
+    while ( true ) {
+        helpersStart_.wait( lock, [&] { return helpersExit_ || helpersGeneration_ != generation; } );
+        if ( helpersExit_ ) {
+            return;
+        }
+        generation = helpersGeneration_;
+        const ThreadTask& task = *helpersTask_;
+
+        lock.unlock();
+        task( *helpers_[index], index + 1 );
+        lock.lock();
+
+        if ( --helpersRunning_ == 0 ) {
+            helpersDone_.notify_one();
+        }
+    }
+}
+
+void Search::stopHelpers() {
+    {
+        std::lock_guard<std::mutex> lock( helpersMutex_ );
+        helpersExit_ = true;
+    }
+    helpersStart_.notify_all();
+    for ( auto& thread : helperThreads_ ) {
+        thread.join();
+    }
+    helperThreads_.clear();
+    helpers_.clear();
+    helpersExit_ = false;
+}
+
+// Pondered move was played, the running search continues within its time limit
+void Search::ponderHit() {
+    pondering_ = false;
+    pondering_.notify_all();
+}
+
+// Called every NODES_BETWEEN_CHECKS nodes, stops the search when the limits are reached
+void Search::checkLimits( int nodes ) const {
+    const uint64_t totalNodes = control_->nodes += nodes;
+
+    if ( control_->nodeLimit > 0 && totalNodes >= control_->nodeLimit ) {
+        *control_->stop = true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if ( control_->hasDeadline && !*control_->pondering && now >= control_->deadline ) {
+        *control_->stop = true;
+    }
+
+    // Progress is reported only by the thread that started the search
+    if ( reportsProgress_ && control_->onInfo != nullptr &&
+         now - control_->lastInfo >= std::chrono::milliseconds( INFO_INTERVAL ) ) {
+        control_->lastInfo = now;
+        ( *control_->onInfo )( makeInfo( control_->bestMove.score, totalNodes, false ) );
+    }
+}
+
+SearchInfo Search::makeInfo( int score, uint64_t nodes, bool completed ) const {
+    const int64_t time = elapsed();
+    const uint64_t nps = nodes * 1000 / std::max<int64_t>( time, 1 );
+    return { control_->depth, score, nodes, time, nps, control_->bestMove, control_->pv, control_->lines, completed };
+}
+
+int64_t Search::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - control_->start )
+        .count();
+}
+
 /**
  * Calculates the score for the current board and player, recursively searching the game tree.
  *
  * @param board position to examine.
+ * @param ply distance from the root, selects the preallocated state of the node.
  * @param depth maximum depth of search.
  * @param alpha maximizing player best score.
  * @param beta minimizing player best score.
- * @param maximizingPlayer true if the current player is WHITE, false if BLACK.
+ * @param stats counters of the searching thread.
+ * @param pv optional principal variation of the node, filled with the moves that raised the score within the window.
  *
  * @return int score for the current board and player.
  */
-int Search::alphaBeta( const Board& examineBoard, int depth, int alpha, int beta, bool maximizingPlayer,
-                       int& nodesExamined, int& nodesEvaluated, int& nodesPruned ) const {
-    nodesExamined++;
+template <PieceColor Us>
+int Search::alphaBeta( const Board& examineBoard, int ply, int depth, int alpha, int beta, SearchStats& stats,
+                       PvList* pv ) {
+    constexpr PieceColor Them = Us == WHITE ? BLACK : WHITE;
+    stats.nodes++;
+    if ( pv != nullptr ) {
+        pv->clear();
+    }
+
+    // Searches started by Search::search can be interrupted, returned score is discarded then
+    if ( control_ != nullptr ) {
+        if ( stats.nodes % NODES_BETWEEN_CHECKS == 0 ) {
+            checkLimits( NODES_BETWEEN_CHECKS );
+        }
+        if ( control_->stop->load( std::memory_order_relaxed ) ) {
+            return 0;
+        }
+    }
+
+    // Drawn by the fifty-move rule, Board::makeMove marks it as a stalemate
+    if ( examineBoard.staleMate ) {
+        return 0;
+    }
+    // Neither side can win, no need to search further
+    if ( MaterialTable::getInstance().probe( examineBoard.materialKey ).knownDraw ) {
+        stats.materialDraws++;
+        return 0;
+    }
+    // Drawn endings found in the bitbases, won endings are still searched to make progress towards the mate
+    bool win;
+    if ( Bitbase::probe( examineBoard, win ) && !win ) {
+        stats.bitbaseDraws++;
+        return 0;
+    }
+
     if ( depth == 0 ) {
-        nodesEvaluated++;
+        stats.evaluations++;
         return Evaluation::evaluateBoard( examineBoard );
     }
 
     // If no legal moves found we decide that the game is over.
     bool isEndOfTheGame = true;
 
-    std::vector<MoveContent> possibleMoves = getPossibleMoves( examineBoard );
+    MoveList& possibleMoves = plies_[ply].moves;
+    getPossibleMoves<Us>( examineBoard, possibleMoves );
+    SearchPly& child = plies_[ply + 1];
 
-    /* ---------------------------- Maximizing Player --------------------------- */
-    if ( maximizingPlayer ) {
-        std::sort( possibleMoves.begin(), possibleMoves.end(), MoveContent::compareMax );
+    {
+        TRACE_SCOPE( "Search::sortMoves" );
+        std::sort( possibleMoves.begin(), possibleMoves.end(),
+                   Us == WHITE ? MoveContent::compareMax : MoveContent::compareMin );
+    }
 
-        for ( auto move : possibleMoves ) {
-            auto board = examineBoard;
-            board.makeMove( move.src, move.dest, move.promotion );
-            generator.generateValidMoves( board );
-            if ( !generator.validateBoard( board ) ) {
-                continue;
-            }
+    for ( auto move : possibleMoves ) {
+        Board& board = child.board;
+        board = examineBoard;
+        board.makeMove<Us>( move.src, move.dest, move.promotion );
+        generator.generateValidMoves<Them>( board );
+        if ( !generator.validateBoard( board ) ) {
+            continue;
+        }
+
+        // We found a legal move, the game is not over.
+        const bool isFirstMove = isEndOfTheGame;
+        isEndOfTheGame = false;
+        const int eval =
+            alphaBeta<Them>( board, ply + 1, depth - 1, alpha, beta, stats, pv != nullptr ? &child.pv : nullptr );
 
-            // We found a legal move, the game is not over.
-            isEndOfTheGame = false;
-            int eval = alphaBeta( board, depth - 1, alpha, beta, false, nodesExamined, nodesEvaluated, nodesPruned );
+        // White is the maximizing player, black the minimizing one
+        if constexpr ( Us == WHITE ) {
+            if ( pv != nullptr && eval > alpha ) {
+                updatePv( *pv, move, child.pv );
+            }
             alpha = std::max( alpha, eval );
-            if ( beta <= alpha ) {
-                nodesPruned++;
-                break;
+        } else {
+            if ( pv != nullptr && eval < beta ) {
+                updatePv( *pv, move, child.pv );
             }
+            beta = std::min( beta, eval );
+        }
+        if ( beta <= alpha ) {
+            stats.cutoffs++;
+            stats.firstMoveCutoffs += isFirstMove;
+            break;
         }
-        if ( isEndOfTheGame ) return endOfTheGameScore( examineBoard );
+    }
+    if ( isEndOfTheGame ) return endOfTheGameScore( examineBoard );
+
+    return Us == WHITE ? alpha : beta;
+}
+
+template int Search::alphaBeta<WHITE>( const Board& examineBoard, int ply, int depth, int alpha, int beta,
+                                       SearchStats& stats, PvList* pv );
+template int Search::alphaBeta<BLACK>( const Board& examineBoard, int ply, int depth, int alpha, int beta,
+                                       SearchStats& stats, PvList* pv );
+
+/* -------------------------------------------------------------------------- */
+/*                                Statistics                                  */
+/* -------------------------------------------------------------------------- */
 
-        return alpha;
+double SearchStats::effectiveBranchingFactor() const {
+    if ( iterations.size() < 2 || iterations[iterations.size() - 2].nodes == 0 ) {
+        return 0.0;
     }
-    /* ---------------------------- Minimizing player --------------------------- */
-    else {
-        std::sort( possibleMoves.begin(), possibleMoves.end(), MoveContent::compareMin );
+    return double( iterations.back().nodes ) / iterations[iterations.size() - 2].nodes;
+}
 
-        for ( auto move : possibleMoves ) {
-            auto board = examineBoard;
-            board.makeMove( move.src, move.dest, move.promotion );
-            generator.generateValidMoves( board );
-            if ( !generator.validateBoard( board ) ) {
-                continue;
-            }
+SearchStats& SearchStats::operator+=( const SearchStats& other ) {
+    nodes += other.nodes;
+    evaluations += other.evaluations;
+    cutoffs += other.cutoffs;
+    firstMoveCutoffs += other.firstMoveCutoffs;
+    materialDraws += other.materialDraws;
+    bitbaseDraws += other.bitbaseDraws;
+    pawnHashProbes += other.pawnHashProbes;
+    pawnHashHits += other.pawnHashHits;
+    return *this;
+}
 
-            isEndOfTheGame = false;
-            int eval = alphaBeta( board, depth - 1, alpha, beta, true, nodesExamined, nodesEvaluated, nodesPruned );
-            beta = std::min( beta, eval );
-            if ( beta <= alpha ) {
-                nodesPruned++;
-                break;
-            }
-        }
-        if ( isEndOfTheGame ) return endOfTheGameScore( examineBoard );
+void SearchStats::print( std::ostream& out ) const {
+    out << "nodes " << nodes << " evaluations " << evaluations << " ebf " << effectiveBranchingFactor()
+        << " cutoffs " << cutoffs << " firstmovecutoffs " << firstMoveCutoffRate() << " materialdraws "
+        << materialDraws << " bitbasedraws " << bitbaseDraws << " pawnhashhits " << pawnHashHitRate()
+        << " pawnhashusage " << pawnHashUsage << " iterations";
+    for ( const auto& iteration : iterations ) {
+        out << " " << iteration.depth << ":" << iteration.nodes << ":" << iteration.time;
+    }
+}
 
-        return beta;
+// Principal variation of a node is its best move followed by the principal variation of the child
+void Search::updatePv( PvList& pv, const MoveContent& move, const PvList& line ) {
+    pv.clear();
+    pv.push_back( move );
+    for ( const auto& next : line ) {
+        pv.push_back( next );
     }
 }
 
@@ -151,24 +627,44 @@ int Search::endOfTheGameScore( const Board& board ) const {
  * Pseudo evaluation tries to guess which moves are the most promising, so they can be searched first.
  * Moves score for black is negative and for white is positive (black' best move is -inf).
  * It assumes that the board has valid moves calculated.
- * Considerations: captures only (TODO: promotion, enpassant, castling and piece's first move).
+ * Considerations: captures only (TODO: enpassant, castling and piece's first move).
+ * Promoting pawn moves are expanded into one move per promotion piece type.
  *
  * @param board Board to examine, it has to have valid moves calculated.
  *
  * @return vector of pseudo evaluated moves for the current board.
  */
 std::vector<MoveContent> Search::getPossibleMoves( const Board& board ) const {
-    std::vector<MoveContent> moves;
+    MoveList moves;
+    getPossibleMoves( board, moves );
+    return { moves.cbegin(), moves.cend() };
+}
+
+/**
+ * Generates the pseudo evaluated possible moves like getPossibleMoves, without allocating.
+ *
+ * @param board Board to examine, it has to have valid moves calculated.
+ * @param moves list receiving the moves, it is cleared first.
+ */
+void Search::getPossibleMoves( const Board& board, MoveList& moves ) const {
+    board.sideToMove == WHITE ? getPossibleMoves<WHITE>( board, moves ) : getPossibleMoves<BLACK>( board, moves );
+}
+
+template <PieceColor Us>
+void Search::getPossibleMoves( const Board& board, MoveList& moves ) const {
+    TRACE_SCOPE( "Search::getPossibleMoves" );
+    moves.clear();
 
     for ( SquareIndex srcSquare = 0; srcSquare < 64; srcSquare++ ) {
         const auto& pieceMoving = board.squares[srcSquare];
-        if ( pieceMoving == std::nullopt || pieceMoving->color != board.sideToMove ) continue;
+        if ( pieceMoving == std::nullopt || pieceMoving->color != Us ) continue;
 
         MoveContent move;
         move.src = srcSquare;
         for ( auto destSquare : pieceMoving->validMoves ) {
             move.dest = destSquare;
             move.pieceMoving = pieceMoving->type;
+            move.score = 0;
             const auto& pieceTaken = board.squares[destSquare];
             pieceTaken ? move.pieceTaken = pieceTaken->type : move.pieceTaken = EMPTY;
 
@@ -179,10 +675,219 @@ std::vector<MoveContent> Search::getPossibleMoves( const Board& board ) const {
                 move.score += pieceTaken->attackedValue - pieceTaken->defendedValue;  // Highest value attacked
             }
 
-            if ( board.sideToMove == BLACK ) move.score = -move.score;
+            if ( Us == BLACK ) move.score = -move.score;
+
+            /* ------------------------------- Promotions ------------------------------- */
+            if ( pieceMoving->type == PAWN && ( Us == WHITE ? destSquare < 8 : destSquare > 55 ) ) {
+                for ( PieceType promotion : { QUEEN, KNIGHT, ROOK, BISHOP } ) {
+                    move.promotion = promotion;
+                    moves.push_back( move );
+                }
+                move.promotion = EMPTY;
+                continue;
+            }
+
             moves.push_back( move );
         }
     }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                              Proof-number search                           */
+/* -------------------------------------------------------------------------- */
 
-    return moves;
-}
\ No newline at end of file
+/**
+ * Looks for a forced mate for the side to move using proof-number search.
+ * Attacker (side to move) only considers checking moves, defender considers all legal evasions.
+ * Mates are searched with increasing length, so the shortest mate within maxMoves is returned.
+ * It assumes that the board has valid moves calculated and the game is not over yet!
+ *
+ * @param examineBoard position to examine.
+ * @param maxMoves maximum number of attacker moves in the mating line (mate in maxMoves).
+ * @param maxNodes maximum number of proof tree nodes per iteration, search gives up when exceeded.
+ *
+ * @return mating line starting with the attacker move, empty if no mate was proven.
+ */
+std::vector<MoveContent> Search::findMate( const Board& examineBoard, int maxMoves, int maxNodes ) const {
+    std::vector<ProofNode> tree;
+
+    for ( int mateIn = 1; mateIn <= maxMoves; mateIn++ ) {
+        tree.clear();
+        if ( !proveMate( examineBoard, 2 * mateIn - 1, maxNodes, tree ) ) {
+            continue;
+        }
+
+        // Follow proven nodes from the root to recover the mating line
+        std::vector<MoveContent> line;
+        uint32_t nodeIndex = 0;
+        while ( tree[nodeIndex].expanded && tree[nodeIndex].childCount > 0 ) {
+            const auto& node = tree[nodeIndex];
+            uint32_t next = node.firstChild;
+            for ( uint32_t child = node.firstChild; child < node.firstChild + node.childCount; child++ ) {
+                if ( tree[child].proof == 0 ) {
+                    next = child;
+                    break;
+                }
+            }
+            line.push_back( tree[next].move );
+            nodeIndex = next;
+        }
+        return line;
+    }
+
+    return {};
+}
+
+/**
+ * Runs a single proof-number search iteration with a fixed ply horizon.
+ *
+ * @param examineBoard root position, attacker to move.
+ * @param maxPlies number of plies within which the defender has to be mated.
+ * @param maxNodes maximum size of the proof tree.
+ * @param tree proof tree storage, filled by the search.
+ *
+ * @return true if the root was proven to be a forced mate.
+ */
+bool Search::proveMate( const Board& examineBoard, int maxPlies, int maxNodes, std::vector<ProofNode>& tree ) const {
+    tree.push_back( ProofNode{ MoveContent(), 0, 0, 0, 1, 1, 0, false } );
+
+    while ( tree[0].proof != 0 && tree[0].disproof != 0 && tree.size() < (size_t)maxNodes ) {
+        // Select the most proving node, replaying its moves on the board
+        Board board = examineBoard;
+        uint32_t nodeIndex = 0;
+        while ( tree[nodeIndex].expanded ) {
+            const auto& node = tree[nodeIndex];
+            bool attackerToMove = node.ply % 2 == 0;
+            uint32_t best = node.firstChild;
+            for ( uint32_t child = node.firstChild; child < node.firstChild + node.childCount; child++ ) {
+                if ( ( attackerToMove && tree[child].proof < tree[best].proof ) ||
+                     ( !attackerToMove && tree[child].disproof < tree[best].disproof ) ) {
+                    best = child;
+                }
+            }
+            board.makeMove( tree[best].move.src, tree[best].move.dest, tree[best].move.promotion );
+            nodeIndex = best;
+        }
+
+        generator.generateValidMoves( board );
+        expandProofNode( tree, nodeIndex, board, maxPlies );
+        updateProofNumbers( tree, nodeIndex );
+    }
+
+    return tree[0].proof == 0;
+}
+
+/**
+ * Creates and initializes children of the given proof tree node.
+ * Children of attacker nodes are checking moves only, children of defender nodes are all legal moves.
+ * Mates, stalemates and positions beyond the horizon are resolved immediately.
+ *
+ * @param tree proof tree storage.
+ * @param nodeIndex index of the node to expand.
+ * @param board position of the node, it has to have valid moves calculated.
+ * @param maxPlies number of plies within which the defender has to be mated.
+ */
+void Search::expandProofNode( std::vector<ProofNode>& tree, uint32_t nodeIndex, const Board& board,
+                              int maxPlies ) const {
+    const int ply = tree[nodeIndex].ply;
+    const bool attackerToMove = ply % 2 == 0;
+    const PieceColor defender = attackerToMove ? ( board.sideToMove == WHITE ? BLACK : WHITE ) : board.sideToMove;
+    const uint32_t firstChild = tree.size();
+
+    for ( const auto& move : getPossibleMoves( board ) ) {
+        Board child = board;
+        child.makeMove( move.src, move.dest, move.promotion );
+        generator.generateValidMoves( child );
+        if ( !generator.validateBoard( child ) ) {
+            continue;
+        }
+
+        bool defenderIsChecked = defender == WHITE ? child.whiteIsChecked : child.blackIsChecked;
+        ProofNode node{ move, nodeIndex, 0, 0, 1, 1, ply + 1, false };
+
+        // Attacker move - only checks are considered, defender is to move in the child
+        if ( attackerToMove ) {
+            if ( !defenderIsChecked ) {
+                continue;
+            }
+            int evasions = child.staleMate ? 0 : countLegalMoves( child );
+            if ( evasions == 0 && !child.staleMate ) {
+                node.proof = 0;
+                node.disproof = PN_INFINITY;
+            } else if ( child.staleMate || ply + 1 >= maxPlies ) {
+                node.proof = PN_INFINITY;
+                node.disproof = 0;
+            } else {
+                node.proof = evasions;
+            }
+        }
+        // Defender move - drawn positions cannot be won anymore
+        else if ( child.staleMate ) {
+            node.proof = PN_INFINITY;
+            node.disproof = 0;
+        }
+
+        tree.push_back( node );
+    }
+
+    tree[nodeIndex].expanded = true;
+    tree[nodeIndex].firstChild = firstChild;
+    tree[nodeIndex].childCount = tree.size() - firstChild;
+}
+
+/**
+ * Recalculates proof and disproof numbers from the given node up to the root.
+ * Attacker nodes need one proven child, defender nodes need all children proven.
+ *
+ * @param tree proof tree storage.
+ * @param nodeIndex index of the most recently expanded node.
+ */
+void Search::updateProofNumbers( std::vector<ProofNode>& tree, uint32_t nodeIndex ) const {
+    while ( true ) {
+        auto& node = tree[nodeIndex];
+        bool attackerToMove = node.ply % 2 == 0;
+        uint32_t minimum = PN_INFINITY;
+        uint32_t sum = 0;
+
+        for ( uint32_t child = node.firstChild; child < node.firstChild + node.childCount; child++ ) {
+            uint32_t minimized = attackerToMove ? tree[child].proof : tree[child].disproof;
+            uint32_t summed = attackerToMove ? tree[child].disproof : tree[child].proof;
+            minimum = std::min( minimum, minimized );
+            sum = std::min( PN_INFINITY, sum + summed );
+        }
+
+        // No checking moves for the attacker or no evasions for the defender
+        if ( node.childCount == 0 ) {
+            minimum = attackerToMove ? PN_INFINITY : 0;
+            sum = attackerToMove ? 0 : PN_INFINITY;
+        }
+
+        node.proof = attackerToMove ? minimum : sum;
+        node.disproof = attackerToMove ? sum : minimum;
+
+        if ( nodeIndex == 0 ) {
+            break;
+        }
+        nodeIndex = node.parent;
+    }
+}
+
+/**
+ * Counts legal moves for the side to move.
+ *
+ * @param board position to examine, it has to have valid moves calculated.
+ *
+ * @return number of fully legal moves.
+ */
+int Search::countLegalMoves( const Board& board ) const {
+    int count = 0;
+    for ( const auto& move : getPossibleMoves( board ) ) {
+        Board child = board;
+        child.makeMove( move.src, move.dest, move.promotion );
+        generator.generateValidMoves( child );
+        if ( generator.validateBoard( child ) ) {
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,66 @@
+#include "Trace.h"
+
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+const std::chrono::steady_clock::time_point Trace::start_ = std::chrono::steady_clock::now();
+
+// Registry is locked only when a thread records its first event, when writing and when clearing
+static std::mutex registryMutex;
+static std::vector<std::shared_ptr<TraceBuffer>> buffers;
+static std::atomic<int> nextThreadId = 1;
+static std::atomic<uint64_t> generation = 0;  // Incremented by clear, so threads register new buffers
+
+/* --------------------------------- Buffers -------------------------------- */
+
+std::vector<TraceEvent> TraceBuffer::events() const {
+    const uint64_t count = count_.load( std::memory_order_acquire );
+    const uint64_t first = count > TRACE_BUFFER_SIZE ? count - TRACE_BUFFER_SIZE : 0;
+    std::vector<TraceEvent> events;
+    events.reserve( count - first );
+    for ( uint64_t i = first; i < count; i++ ) {
+        events.push_back( events_[i & ( TRACE_BUFFER_SIZE - 1 )] );
+    }
+    return events;
+}
+
+TraceBuffer &Trace::threadBuffer() {
+    static thread_local std::shared_ptr<TraceBuffer> buffer;
+    static thread_local uint64_t bufferGeneration = 0;
+    if ( buffer == nullptr || bufferGeneration != generation.load( std::memory_order_acquire ) ) {
+        std::lock_guard<std::mutex> lock( registryMutex );
+        buffer = std::make_shared<TraceBuffer>( nextThreadId++ );
+        bufferGeneration = generation;
+        buffers.push_back( buffer );
+    }
+    return *buffer;
+}
+
+/* --------------------------------- Output --------------------------------- */
+
+/**
+ * Writes complete ("X") events of all threads, timestamps and durations are in microseconds.
+ *
+ * @param out stream receiving the JSON object.
+ */
+void Trace::write( std::ostream &out ) {
+    std::lock_guard<std::mutex> lock( registryMutex );
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::fixed << std::setprecision( 3 );
+    bool isFirst = true;
+    for ( const auto &buffer : buffers ) {
+        for ( const auto &event : buffer->events() ) {
+            out << ( isFirst ? "\n" : ",\n" ) << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << buffer->threadId() << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0
+                << "}";
+            isFirst = false;
+        }
+    }
+    out << "\n]}" << std::defaultfloat << std::endl;
+}
+
+void Trace::clear() {
+    std::lock_guard<std::mutex> lock( registryMutex );
+    buffers.clear();
+    generation++;
+}
@@ -0,0 +1,330 @@
+#include "Tuner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <string>
+#include <thread>
+
+#include "Evaluation.h"
+#include "Material.h"
+
+static const double LN_10 = std::log( 10.0 );
+static const double ADAM_BETA1 = 0.9;
+static const double ADAM_BETA2 = 0.999;
+static const double ADAM_EPSILON = 1e-8;
+
+/* ------------------------------ Constructors ------------------------------ */
+
+Tuner::Tuner( int threads )
+    : threads_( std::max( threads, 1 ) ), parameters_( PARAMETER_COUNT, 0.0 ), featureOffsets_( 1, 0 ),
+      termCounts_( PARAMETER_COUNT, 0 ) {
+    for ( int type = ROOK; type <= PAWN; type++ ) {
+        parameters_[PIECE_VALUES_INDEX + type] = PIECE_VALUES[type];
+        for ( GameStage stage : { MIDDLE_GAME, END_GAME } ) {
+            for ( int square = 0; square < 64; square++ ) {
+                parameters_[PIECE_SQUARE_INDEX + ( stage * 7 + type ) * 64 + square] =
+                    PIECE_SQUARE_TABLES[stage][type][square];
+            }
+        }
+    }
+    for ( GameStage stage : { MIDDLE_GAME, END_GAME } ) {
+        parameters_[DOUBLED_PAWN_INDEX + stage] = DOUBLED_PAWN_PENALTY[stage];
+        parameters_[ISOLATED_PAWN_INDEX + stage] = ISOLATED_PAWN_PENALTY[stage];
+        parameters_[BACKWARD_PAWN_INDEX + stage] = BACKWARD_PAWN_PENALTY[stage];
+        parameters_[PAWN_SHIELD_INDEX + stage] = PAWN_SHIELD_BONUS[stage];
+        for ( int rank = 0; rank < 8; rank++ ) {
+            parameters_[PASSED_PAWN_INDEX + stage * 8 + rank] = PASSED_PAWN_BONUS[stage][rank];
+        }
+    }
+    parameters_[BISHOP_PAIR_INDEX] = BISHOP_PAIR_BONUS;
+    parameters_[KNIGHT_PAWN_INDEX] = KNIGHT_PAWN_ADJUSTMENT;
+    parameters_[ROOK_PAWN_INDEX] = ROOK_PAWN_ADJUSTMENT;
+}
+
+/* -------------------------------- Positions ------------------------------- */
+
+// Returns the end game parameter of the term, terms shared by both stages have only one parameter
+int Tuner::endGameIndex( int index ) {
+    if ( index >= PIECE_SQUARE_INDEX && index < PIECE_SQUARE_INDEX + 7 * 64 ) {
+        return index + 7 * 64;
+    }
+    if ( index >= DOUBLED_PAWN_INDEX && index < PASSED_PAWN_INDEX && ( index - DOUBLED_PAWN_INDEX ) % 2 == 0 ) {
+        return index + 1;
+    }
+    if ( index >= PASSED_PAWN_INDEX && index < PASSED_PAWN_INDEX + 8 ) {
+        return index + 8;
+    }
+    return index;
+}
+
+/**
+ * Extracts the evaluation terms of the position, the same terms Evaluation::evaluateBoard weights.
+ *
+ * @param board position to add.
+ * @param result game result from the white point of view, 1 for a white win, 0.5 for a draw and 0 for a loss.
+ *
+ * @return false if the position is not evaluated by the linear evaluation and was skipped.
+ */
+bool Tuner::addPosition( const Board &board, double result ) {
+    const MaterialEntry &material = MaterialTable::getInstance().probe( board.materialKey );
+    if ( material.knownDraw || material.endgame != nullptr ) {
+        return false;
+    }
+
+    // Pieces and their squares, tables are written from the white point of view
+    for ( SquareIndex square = 0; square < 64; square++ ) {
+        const auto &piece = board.squares[square];
+        if ( !piece ) {
+            continue;
+        }
+        const int sign = piece->color == WHITE ? 1 : -1;
+        const int tableSquare = piece->color == WHITE ? square : 63 - square;
+        termCounts_[PIECE_VALUES_INDEX + piece->type] += sign;
+        termCounts_[PIECE_SQUARE_INDEX + piece->type * 64 + tableSquare] += sign;
+    }
+
+    // Pawn structure, penalties are subtracted
+    const PawnTerms pawns = Evaluation::countPawnTerms( board );
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        const int sign = color == WHITE ? 1 : -1;
+        termCounts_[DOUBLED_PAWN_INDEX] -= sign * pawns.doubled[color];
+        termCounts_[ISOLATED_PAWN_INDEX] -= sign * pawns.isolated[color];
+        termCounts_[BACKWARD_PAWN_INDEX] -= sign * pawns.backward[color];
+        termCounts_[PAWN_SHIELD_INDEX] += sign * pawns.shield[color];
+        for ( int rank = 0; rank < 8; rank++ ) {
+            termCounts_[PASSED_PAWN_INDEX + rank] += sign * pawns.passed[color][rank];
+        }
+
+        // Material imbalance
+        const uint64_t key = board.materialKey;
+        const int ownPawns = MaterialTable::pieceCount( key, color, PAWN );
+        termCounts_[BISHOP_PAIR_INDEX] += sign * ( MaterialTable::pieceCount( key, color, BISHOP ) >= 2 );
+        termCounts_[KNIGHT_PAWN_INDEX] += sign * MaterialTable::pieceCount( key, color, KNIGHT ) * ( ownPawns - 5 );
+        termCounts_[ROOK_PAWN_INDEX] += sign * MaterialTable::pieceCount( key, color, ROOK ) * ( ownPawns - 5 );
+    }
+
+    // Only the terms which do not cancel out are stored
+    for ( int index = 0; index < PARAMETER_COUNT; index++ ) {
+        if ( termCounts_[index] != 0 ) {
+            features_.push_back( { uint16_t( index ), uint16_t( endGameIndex( index ) ), int16_t( termCounts_[index] ) } );
+            termCounts_[index] = 0;
+        }
+    }
+    featureOffsets_.push_back( features_.size() );
+    phases_.push_back( material.phase );
+    results_.push_back( result );
+    return true;
+}
+
+void Tuner::addPositions( const PositionFile &file ) {
+    for ( const auto &position : file ) {
+        if ( position.result != PackedPosition::NO_RESULT ) {
+            addPosition( Board( position ), ( position.result + 1 ) / 2.0 );
+        }
+    }
+}
+
+/* ---------------------------------- Loss ---------------------------------- */
+
+double Tuner::evaluate( std::size_t position ) const {
+    const double middleGame = phases_[position] / double( TOTAL_PHASE );
+    double score = 0.0;
+    for ( uint64_t i = featureOffsets_[position]; i < featureOffsets_[position + 1]; i++ ) {
+        const Feature &feature = features_[i];
+        score += feature.count * ( middleGame * parameters_[feature.index] +
+                                   ( 1 - middleGame ) * parameters_[feature.endGameIndex] );
+    }
+    return score;
+}
+
+/**
+ * Calculates the loss over all positions, positions are split into consecutive ranges, one per thread.
+ *
+ * @param scale scaling constant of the win probability.
+ * @param gradient optional vector receiving the gradient of the loss by the parameters.
+ *
+ * @return mean squared error of the predicted win probabilities.
+ */
+double Tuner::computeLoss( double scale, std::vector<double> *gradient ) const {
+    const std::size_t positions = size();
+    if ( positions == 0 ) {
+        return 0.0;
+    }
+
+    std::vector<double> losses( threads_, 0.0 );
+    std::vector<std::vector<double>> gradients( gradient != nullptr ? threads_ : 0 );
+    auto worker = [&]( int thread ) {
+        const std::size_t begin = positions * thread / threads_;
+        const std::size_t end = positions * ( thread + 1 ) / threads_;
+        double loss = 0.0;
+        if ( gradient != nullptr ) {
+            gradients[thread].assign( PARAMETER_COUNT, 0.0 );
+        }
+
+        for ( std::size_t position = begin; position < end; position++ ) {
+            const double probability = 1.0 / ( 1.0 + std::exp( -scale * evaluate( position ) * LN_10 / 400.0 ) );
+            const double error = results_[position] - probability;
+            loss += error * error;
+            if ( gradient == nullptr ) {
+                continue;
+            }
+
+            // Derivative of the loss by the evaluation, split between the stages by the game phase
+            const double derivative = -2.0 * error * probability * ( 1 - probability ) * scale * LN_10 / 400.0;
+            const double middleGame = phases_[position] / double( TOTAL_PHASE );
+            std::vector<double> &threadGradient = gradients[thread];
+            for ( uint64_t i = featureOffsets_[position]; i < featureOffsets_[position + 1]; i++ ) {
+                const Feature &feature = features_[i];
+                threadGradient[feature.index] += derivative * feature.count * middleGame;
+                threadGradient[feature.endGameIndex] += derivative * feature.count * ( 1 - middleGame );
+            }
+        }
+        losses[thread] = loss;
+    };
+
+    std::vector<std::thread> pool;
+    for ( int thread = 1; thread < threads_; thread++ ) {
+        pool.emplace_back( worker, thread );
+    }
+    worker( 0 );
+    for ( auto &thread : pool ) {
+        thread.join();
+    }
+
+    if ( gradient != nullptr ) {
+        gradient->assign( PARAMETER_COUNT, 0.0 );
+        for ( const auto &threadGradient : gradients ) {
+            for ( int index = 0; index < PARAMETER_COUNT; index++ ) {
+                ( *gradient )[index] += threadGradient[index] / positions;
+            }
+        }
+    }
+    double loss = 0.0;
+    for ( double threadLoss : losses ) {
+        loss += threadLoss;
+    }
+    return loss / positions;
+}
+
+// Golden section search, loss is unimodal in the scaling constant
+double Tuner::findScale() const {
+    const double ratio = ( std::sqrt( 5.0 ) - 1 ) / 2;
+    double low = 0.0, high = 4.0;
+    for ( int i = 0; i < TUNER_SCALE_ITERATIONS; i++ ) {
+        const double left = high - ratio * ( high - low );
+        const double right = low + ratio * ( high - low );
+        if ( loss( left ) < loss( right ) ) {
+            high = right;
+        } else {
+            low = left;
+        }
+    }
+    return ( low + high ) / 2;
+}
+
+/**
+ * Minimizes the loss by the Adam gradient descent over all positions.
+ *
+ * @param iterations number of gradient steps.
+ * @param scale scaling constant of the win probability, see findScale.
+ * @param learningRate largest change of a parameter in a single step, centipawns.
+ * @param onIteration optional callback receiving the iteration and the loss before the step.
+ */
+void Tuner::tune( int iterations, double scale, double learningRate,
+                  const std::function<void( int, double )> &onIteration ) {
+    std::vector<double> gradient, moment( PARAMETER_COUNT, 0.0 ), velocity( PARAMETER_COUNT, 0.0 );
+    for ( int iteration = 1; iteration <= iterations; iteration++ ) {
+        const double loss = computeLoss( scale, &gradient );
+        if ( onIteration ) {
+            onIteration( iteration, loss );
+        }
+
+        const double momentCorrection = 1 - std::pow( ADAM_BETA1, iteration );
+        const double velocityCorrection = 1 - std::pow( ADAM_BETA2, iteration );
+        for ( int index = 0; index < PARAMETER_COUNT; index++ ) {
+            moment[index] = ADAM_BETA1 * moment[index] + ( 1 - ADAM_BETA1 ) * gradient[index];
+            velocity[index] = ADAM_BETA2 * velocity[index] + ( 1 - ADAM_BETA2 ) * gradient[index] * gradient[index];
+            parameters_[index] -= learningRate * ( moment[index] / momentCorrection ) /
+                                  ( std::sqrt( velocity[index] / velocityCorrection ) + ADAM_EPSILON );
+        }
+    }
+}
+
+/* --------------------------------- Output --------------------------------- */
+
+/**
+ * Writes the parameters in the format of EvaluationParameters.h, which can replace the header as it is.
+ * Piece square values are limited to the range of their int8_t tables.
+ *
+ * @param out stream receiving the header.
+ */
+void Tuner::writeParameters( std::ostream &out ) const {
+    auto value = [&]( int index ) { return int( std::lround( parameters_[index] ) ); };
+    auto stagePair = [&]( int index ) {
+        return "{ " + std::to_string( value( index ) ) + ", " + std::to_string( value( index + 1 ) ) + " }";
+    };
+    const char *pieceNames[7] = { "", "ROOK", "KNIGHT", "BISHOP", "QUEEN", "KING", "PAWN" };
+
+    out << "#ifndef EVALUATION_PARAMETERS_H\n#define EVALUATION_PARAMETERS_H\n\n#include <cstdint>\n\n"
+        << "// Evaluation weights, regenerated by chess-cli tune\n\n"
+        << "/* ------------------------------ PIECE VALUES ------------------------------ */\n\n";
+    for ( int type : { PAWN, KNIGHT, BISHOP, ROOK, QUEEN } ) {
+        out << "auto const " << pieceNames[type] << "_VALUE = " << value( PIECE_VALUES_INDEX + type ) << ";\n";
+    }
+    out << "auto const KING_VALUE = " << KING_VALUE << ";\n\n"
+        << "// Piece values indexed by PieceType\n"
+        << "const int PIECE_VALUES[7] = { 0, ROOK_VALUE, KNIGHT_VALUE, BISHOP_VALUE, QUEEN_VALUE, KING_VALUE, "
+           "PAWN_VALUE };\n\n";
+
+    out << "/* ------------------------ PAWN STRUCTURE EVALUATION ----------------------- */\n\n"
+        << "// Middle game and end game values indexed by GameStage\n"
+        << "const int DOUBLED_PAWN_PENALTY[2] = " << stagePair( DOUBLED_PAWN_INDEX ) << ";\n"
+        << "const int ISOLATED_PAWN_PENALTY[2] = " << stagePair( ISOLATED_PAWN_INDEX ) << ";\n"
+        << "const int BACKWARD_PAWN_PENALTY[2] = " << stagePair( BACKWARD_PAWN_INDEX ) << ";\n"
+        << "const int PAWN_SHIELD_BONUS[2] = " << stagePair( PAWN_SHIELD_INDEX ) << ";\n\n"
+        << "// Passed pawn bonus indexed by GameStage and the rank of the pawn as seen from its owner's side "
+           "(0 is the first rank)\n"
+        << "const int PASSED_PAWN_BONUS[2][8] = {\n";
+    for ( GameStage stage : { MIDDLE_GAME, END_GAME } ) {
+        out << "    {";
+        for ( int rank = 0; rank < 8; rank++ ) {
+            out << ( rank > 0 ? ", " : " " ) << value( PASSED_PAWN_INDEX + stage * 8 + rank );
+        }
+        out << " },\n";
+    }
+    out << "};\n\n";
+
+    out << "/* --------------------------- MATERIAL IMBALANCE --------------------------- */\n\n"
+        << "auto const BISHOP_PAIR_BONUS = " << value( BISHOP_PAIR_INDEX ) << ";\n"
+        << "auto const KNIGHT_PAWN_ADJUSTMENT = " << value( KNIGHT_PAWN_INDEX )
+        << ";  // Knight value change per own pawn above five\n"
+        << "auto const ROOK_PAWN_ADJUSTMENT = " << value( ROOK_PAWN_INDEX )
+        << ";  // Rook value change per own pawn above five\n\n";
+
+    out << "/* ---------------------- SQUARE PIECE EVALUATION MAPS ---------------------- */\n\n"
+        << "// Tables are seen from the white side, square 0 is a8\n"
+        << "// clang-format off\n";
+    for ( GameStage stage : { MIDDLE_GAME, END_GAME } ) {
+        for ( int type : { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING } ) {
+            out << "const int8_t " << pieceNames[type] << ( stage == END_GAME ? "_END_GAME" : "" )
+                << "_TABLE[64] = {\n";
+            for ( int square = 0; square < 64; square++ ) {
+                const int squareValue = std::clamp( value( PIECE_SQUARE_INDEX + ( stage * 7 + type ) * 64 + square ),
+                                                    int( INT8_MIN ), int( INT8_MAX ) );
+                out << ( square % 8 == 0 ? "   " : "" ) << std::setw( 4 ) << squareValue
+                    << ( square % 8 == 7 ? ",\n" : "," );
+            }
+            out << "};\n\n";
+        }
+    }
+    out << "// clang-format on\n\n";
+
+    out << "/* -------------------- PIECE SQUARE TABLES BY GAME STAGE ------------------- */\n\n"
+        << "// Tables indexed by GameStage and PieceType\n"
+        << "const int8_t* const PIECE_SQUARE_TABLES[2][7] = {\n"
+        << "    { nullptr, ROOK_TABLE, KNIGHT_TABLE, BISHOP_TABLE, QUEEN_TABLE, KING_TABLE, PAWN_TABLE },\n"
+        << "    { nullptr, ROOK_END_GAME_TABLE, KNIGHT_END_GAME_TABLE, BISHOP_END_GAME_TABLE, QUEEN_END_GAME_TABLE,\n"
+        << "      KING_END_GAME_TABLE, PAWN_END_GAME_TABLE },\n"
+        << "};\n\n#endif\n";
+}
@@ -0,0 +1,281 @@
+#include "Uci.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "Evaluation.h"
+
+/* ------------------------------ Constructors ------------------------------ */
+
+Uci::Uci( std::istream &in, std::ostream &out ) : in_( in ), out_( out ), stop_( false ) {
+    generator_.generateValidMoves( board_ );
+}
+
+Uci::~Uci() { stopSearch(); }
+
+/* --------------------------------- Methods -------------------------------- */
+
+void Uci::loop() {
+    std::string command;
+    while ( std::getline( in_, command ) ) {
+        if ( !execute( command ) ) {
+            return;
+        }
+    }
+    stopSearch();
+}
+
+/**
+ * Executes a single UCI command.
+ * Unknown commands are reported with info string and ignored, as the protocol requires.
+ *
+ * @param command line received from the GUI.
+ *
+ * @return false if the command was quit.
+ */
+bool Uci::execute( const std::string &command ) {
+    std::istringstream stream( command );
+    std::string token;
+    stream >> token;
+
+    try {
+        if ( token == "uci" ) {
+            std::ostringstream message;
+            message << "id name " << ENGINE_NAME << "\n";
+            message << "id author " << ENGINE_AUTHOR << "\n";
+            message << "option name Hash type spin default " << DEFAULT_HASH_SIZE << " min 1 max " << MAX_HASH_SIZE
+                    << "\n";
+            message << "option name Threads type spin default 1 min 1 max " << MAX_THREADS << "\n";
+            message << "option name Ponder type check default false\n";
+            message << "option name MultiPV type spin default 1 min 1 max " << MAX_MULTI_PV << "\n";
+            message << "uciok";
+            send( message.str() );
+        } else if ( token == "debug" ) {
+            stream >> token;
+            debug_ = token == "on";
+        } else if ( token == "isready" ) {
+            send( "readyok" );
+        } else if ( token == "ucinewgame" ) {
+            stopSearch();
+            board_ = Board();
+            generator_.generateValidMoves( board_ );
+        } else if ( token == "position" ) {
+            position( stream );
+        } else if ( token == "go" ) {
+            go( stream );
+        } else if ( token == "stop" ) {
+            stopSearch();
+        } else if ( token == "ponderhit" ) {
+            search_.ponderHit();
+        } else if ( token == "setoption" ) {
+            setOption( stream );
+        } else if ( token == "quit" ) {
+            stopSearch();
+            return false;
+        } else if ( !token.empty() ) {
+            send( "info string unknown command " + token );
+        }
+    } catch ( const std::exception &e ) {
+        send( std::string( "info string " ) + e.what() );
+    }
+    return true;
+}
+
+void Uci::waitForSearch() {
+    if ( searchThread_.joinable() ) {
+        searchThread_.join();
+    }
+}
+
+/* -------------------------------- Commands -------------------------------- */
+
+// position [startpos | fen <fen>] [moves <move>...]
+void Uci::position( std::istringstream &command ) {
+    std::string token, fen;
+    command >> token;
+
+    if ( token == "fen" ) {
+        while ( command >> token && token != "moves" ) {
+            fen += ( fen.empty() ? "" : " " ) + token;
+        }
+    } else if ( token == "startpos" ) {
+        command >> token;
+    } else {
+        throw std::invalid_argument( "position requires startpos or fen" );
+    }
+
+    // Position is replaced only if all the moves are valid
+    Board board = fen.empty() ? Board() : Board( fen );
+    generator_.generateValidMoves( board );
+    while ( command >> token ) {
+        // Board::makeMove does not check how the pieces move
+        const bool isSquareNotation = token.size() >= 4 && token[0] >= 'a' && token[0] <= 'h' && token[1] >= '1' &&
+                                      token[1] <= '8' && token[2] >= 'a' && token[2] <= 'h' && token[3] >= '1' &&
+                                      token[3] <= '8';
+        if ( !isSquareNotation ) {
+            throw std::invalid_argument( "invalid move " + token );
+        }
+        const SquareIndex src = ( '8' - token[1] ) * 8 + token[0] - 'a';
+        const SquareIndex dest = ( '8' - token[3] ) * 8 + token[2] - 'a';
+        const auto &piece = board.squares[src];
+        if ( !piece || std::ranges::find( piece->validMoves, dest ) == piece->validMoves.cend() ) {
+            throw std::invalid_argument( "illegal move " + token );
+        }
+
+        board.makeMove( token );
+        generator_.generateValidMoves( board );
+        if ( !generator_.validateBoard( board ) ) {
+            throw std::invalid_argument( "illegal move " + token );
+        }
+    }
+
+    stopSearch();
+    board_ = board;
+}
+
+// go [depth <plies>] [nodes <count>] [movetime <ms>] [wtime <ms>] [btime <ms>] [winc <ms>] [binc <ms>]
+// [movestogo <moves>] [infinite] [ponder]
+void Uci::go( std::istringstream &command ) {
+    SearchLimits limits;
+    limits.multiPv = multiPv_;
+    bool ponder = false;
+    std::string token;
+
+    while ( command >> token ) {
+        if ( token == "depth" ) {
+            command >> limits.depth;
+        } else if ( token == "nodes" ) {
+            command >> limits.nodes;
+        } else if ( token == "movetime" ) {
+            command >> limits.moveTime;
+        } else if ( token == "wtime" ) {
+            command >> limits.time[WHITE];
+        } else if ( token == "btime" ) {
+            command >> limits.time[BLACK];
+        } else if ( token == "winc" ) {
+            command >> limits.increment[WHITE];
+        } else if ( token == "binc" ) {
+            command >> limits.increment[BLACK];
+        } else if ( token == "movestogo" ) {
+            command >> limits.movesToGo;
+        } else if ( token == "infinite" ) {
+            limits.infinite = true;
+        } else if ( token == "ponder" ) {
+            ponder = true;
+        }
+    }
+
+    stopSearch();
+    stop_ = false;
+    search_.setThreads( threads_ );
+    // Set before the search starts, so an early ponderhit is not lost
+    if ( ponder ) {
+        search_.startPondering();
+    }
+    searchThread_ = std::thread( [this, board = board_, limits] {
+        const PieceColor sideToMove = board.sideToMove;
+        std::vector<MoveContent> pv;
+        SearchStats stats;
+        const MoveContent bestMove = search_.search(
+            board, limits, stop_,
+            [&]( const SearchInfo &info ) {
+                if ( info.completed ) {
+                    pv = info.pv;
+                }
+                sendInfo( info, sideToMove );
+            },
+            &stats );
+        if ( debug_ ) {
+            std::ostringstream message;
+            stats.print( message );
+            send( "info string " + message.str() );
+        }
+
+        // Pondering and infinite searches must not send bestmove before ponderhit or stop
+        search_.waitForPonderHit();
+        if ( limits.infinite ) {
+            stop_.wait( false );
+        }
+
+        // Second move of the principal variation is the expected reply to ponder on
+        std::string message = "bestmove " + bestMove.toUCI();
+        if ( pv.size() > 1 && pv.front().src == bestMove.src && pv.front().dest == bestMove.dest ) {
+            message += " ponder " + pv[1].toUCI();
+        }
+        send( message );
+    } );
+}
+
+// setoption name <name> value <value>
+void Uci::setOption( std::istringstream &command ) {
+    std::string token, name, value;
+    command >> token;
+    while ( command >> token && token != "value" ) {
+        name += ( name.empty() ? "" : " " ) + token;
+    }
+    command >> value;
+
+    if ( name == "Hash" ) {
+        // Pawn hash tables are the only hash tables of the engine
+        const std::size_t megabytes = std::clamp( std::stoi( value ), 1, MAX_HASH_SIZE );
+        Evaluation::setPawnHashSize( std::bit_floor( megabytes * 1024 * 1024 / sizeof( PawnEntry ) ) );
+    } else if ( name == "Threads" ) {
+        // Running search uses the helper threads, so they are changed when the next search starts
+        threads_ = std::clamp( std::stoi( value ), 1, MAX_THREADS );
+    } else if ( name == "MultiPV" ) {
+        multiPv_ = std::clamp( std::stoi( value ), 1, MAX_MULTI_PV );
+    } else if ( name != "Ponder" ) {  // Ponder only allows the GUI to send go ponder, nothing to configure
+        send( "info string unknown option " + name );
+    }
+}
+
+void Uci::stopSearch() {
+    stop_ = true;
+    stop_.notify_all();
+    // Pondering search is stopped as well, its result is discarded by the GUI
+    search_.ponderHit();
+    waitForSearch();
+}
+
+/* --------------------------------- Output --------------------------------- */
+
+// Search thread and the command loop write concurrently, every message is written as a whole
+void Uci::send( const std::string &message ) {
+    std::lock_guard<std::mutex> lock( outputMutex_ );
+    out_ << message << std::endl;
+}
+
+void Uci::sendInfo( const SearchInfo &info, PieceColor sideToMove ) {
+    std::ostringstream progress;
+    progress << " nodes " << info.nodes << " nps " << info.nps << " time " << info.time;
+
+    // Periodic reports in the middle of an iteration have no exact score
+    if ( !info.completed ) {
+        send( "info depth " + std::to_string( info.depth ) + progress.str() );
+        return;
+    }
+
+    for ( std::size_t i = 0; i < info.lines.size(); i++ ) {
+        const PvLine &line = info.lines[i];
+        std::ostringstream message;
+        message << "info depth " << info.depth;
+        if ( info.lines.size() > 1 ) {
+            message << " multipv " << i + 1;
+        }
+
+        // Score is reported from the side to move point of view, mate distance is the length of the mating line
+        if ( line.score == POSITIVE_INFINITY || line.score == NEGATIVE_INFINITY ) {
+            const bool isWinning = ( line.score == POSITIVE_INFINITY ) == ( sideToMove == WHITE );
+            const int mateIn = ( line.pv.size() + 1 ) / 2;
+            message << " score mate " << ( isWinning ? mateIn : -mateIn );
+        } else {
+            message << " score cp " << ( sideToMove == WHITE ? line.score : -line.score );
+        }
+
+        message << progress.str() << " pv";
+        for ( const auto &move : line.pv ) {
+            message << " " << move.toUCI();
+        }
+        send( message.str() );
+    }
+}
@@ -0,0 +1,26 @@
+#include "Zobrist.h"
+
+// Xorshift64* pseudo random number generator with a fixed seed
+static uint64_t nextRandom( uint64_t &state ) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+static std::array<std::array<std::array<uint64_t, 64>, 7>, 2> generatePieceKeys() {
+    std::array<std::array<std::array<uint64_t, 64>, 7>, 2> keys;
+    uint64_t state = 1070372;
+
+    for ( auto &colorKeys : keys ) {
+        for ( auto &typeKeys : colorKeys ) {
+            for ( auto &key : typeKeys ) {
+                key = nextRandom( state );
+            }
+        }
+    }
+
+    return keys;
+}
+
+const std::array<std::array<std::array<uint64_t, 64>, 7>, 2> Zobrist::pieceKeys_ = generatePieceKeys();
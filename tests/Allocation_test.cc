@@ -0,0 +1,69 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "Movegen.h"
+#include "Search.h"
+#include "catch2/catch_test_macros.hpp"
+
+// Every allocation of the test binary goes through these replacements of the global operators
+static std::atomic<uint64_t> allocations = 0;
+
+void *operator new( std::size_t size ) {
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    if ( void *pointer = std::malloc( size == 0 ? 1 : size ) ) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void *pointer ) noexcept {
+    std::free( pointer );
+}
+
+void operator delete( void *pointer, std::size_t ) noexcept {
+    std::free( pointer );
+}
+
+static const char *FENS[] = {
+    "r1bqkbnr/ppp2ppp/2np4/4p3/2B1P3/5Q2/PPPP1PPP/RNB1K1NR w KQkq - 0 2",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "4k3/1P6/8/8/8/8/6p1/4K3 b - - 0 1",
+    "8/8/4k3/8/4P3/4K3/8/8 w - - 0 1",
+};
+
+TEST_CASE( "Search does not allocate after the first search", "[Search.allocation]" ) {
+    Search search;
+    PieceValidMoves generator;
+    for ( auto fen : FENS ) {
+        Board board( fen );
+        generator.generateValidMoves( board );
+        // First search creates the pawn hash of the thread and the material and bitbase tables
+        search.getBestMove( board, 2 );
+
+        const uint64_t before = allocations;
+        search.getBestMove( board, 4 );
+        REQUIRE( allocations - before == 0 );
+    }
+}
+
+TEST_CASE( "Move generation does not allocate", "[Movegen.allocation]" ) {
+    PieceValidMoves generator;
+    Board board( FENS[1] );
+    generator.generateValidMoves( board );
+
+    const uint64_t before = allocations;
+    for ( SquareIndex src = 0; src < 64; src++ ) {
+        if ( !board.squares[src] || board.squares[src]->color != board.sideToMove ) {
+            continue;
+        }
+        for ( SquareIndex dest : board.squares[src]->validMoves ) {
+            Board copy = board;
+            copy.makeMove( src, dest, board.squares[src]->type == PAWN && ( dest < 8 || dest > 55 ) ? QUEEN : EMPTY );
+            generator.generateValidMoves( copy );
+            generator.validateBoard( copy );
+        }
+    }
+    REQUIRE( allocations - before == 0 );
+}
@@ -0,0 +1,31 @@
+#include "Bench.h"
+#include "Movegen.h"
+#include "Search.h"
+#include "catch2/catch_test_macros.hpp"
+
+TEST_CASE( "Bench positions are valid and have legal moves", "[Bench]" ) {
+    REQUIRE( Bench::positions().size() >= 50 );
+    Search search;
+    for ( const auto &fen : Bench::positions() ) {
+        Board board( fen );
+        PieceValidMoves().generateValidMoves( board );
+        REQUIRE_FALSE( search.getPossibleMoves( board ).empty() );
+    }
+}
+
+TEST_CASE( "Bench node count is reproducible", "[Bench]" ) {
+    int positions = 0;
+    const BenchReport first = Bench::run( 2, [&]( const BenchResult &result ) {
+        REQUIRE( result.nodes > 0 );
+        positions++;
+    } );
+    REQUIRE( positions == int( Bench::positions().size() ) );
+    REQUIRE( first.results.size() == Bench::positions().size() );
+
+    const BenchReport second = Bench::run( 2 );
+    REQUIRE( second.nodes == first.nodes );
+    for ( std::size_t i = 0; i < first.results.size(); i++ ) {
+        REQUIRE( second.results[i].move == first.results[i].move );
+    }
+    REQUIRE( Bench::run( 3 ).nodes > first.nodes );
+}
@@ -0,0 +1,55 @@
+#include "Bitbase.h"
+#include "Search.h"
+#include "catch2/catch_test_macros.hpp"
+
+static bool probeWin( std::string FENString ) {
+    bool win = false;
+    REQUIRE( Bitbase::probe( Board( FENString ), win ) );
+    return win;
+}
+
+/* ---------------------------------- Probe --------------------------------- */
+
+TEST_CASE( "Bitbase covers only a single piece against a bare king", "[Bitbase.probe]" ) {
+    bool win;
+    REQUIRE_FALSE( Bitbase::probe( Board(), win ) );
+    REQUIRE_FALSE( Bitbase::probe( Board( "4k3/8/8/8/8/8/8/1N2K3 w - - 0 1" ), win ) );
+    REQUIRE_FALSE( Bitbase::probe( Board( "4k3/4p3/8/8/8/8/4P3/4K3 w - - 0 1" ), win ) );
+    REQUIRE( Bitbase::probe( Board( "4k3/8/8/8/8/8/8/R3K3 w - - 0 1" ), win ) );
+}
+
+TEST_CASE( "KPK bitbase knows the opposition", "[Bitbase.KPK]" ) {
+    REQUIRE_FALSE( probeWin( "8/4k3/8/4K3/4P3/8/8/8 w - - 0 1" ) );
+    REQUIRE( probeWin( "8/4k3/8/4K3/4P3/8/8/8 b - - 0 1" ) );
+
+    // Same positions with colors reversed
+    REQUIRE_FALSE( probeWin( "8/8/8/4p3/4k3/8/4K3/8 b - - 0 1" ) );
+    REQUIRE( probeWin( "8/8/8/4p3/4k3/8/4K3/8 w - - 0 1" ) );
+
+    // Rook pawn with the defending king in front of it
+    REQUIRE_FALSE( probeWin( "1k6/8/8/8/P7/8/8/4K3 w - - 0 1" ) );
+    REQUIRE_FALSE( probeWin( "6k1/8/8/8/7P/8/8/3K4 w - - 0 1" ) );
+    // Defending king too far
+    REQUIRE( probeWin( "7k/8/8/8/P7/8/8/4K3 w - - 0 1" ) );
+}
+
+TEST_CASE( "KRK and KQK bitbases detect lost pieces and stalemates", "[Bitbase.KXK]" ) {
+    REQUIRE( probeWin( "4k3/8/8/8/8/8/8/R3K3 w - - 0 1" ) );
+    REQUIRE( probeWin( "8/8/8/8/8/8/7k/Q3K3 b - - 0 1" ) );
+
+    // Undefended rook is captured
+    REQUIRE_FALSE( probeWin( "8/8/8/8/8/8/1k6/R3K3 b - - 0 1" ) );
+    // Stalemate
+    REQUIRE_FALSE( probeWin( "k7/2Q5/1K6/8/8/8/8/8 b - - 0 1" ) );
+}
+
+/* --------------------------------- Search --------------------------------- */
+
+TEST_CASE( "Search scores drawn bitbase positions as a draw", "[Bitbase.search]" ) {
+    Search s;
+    Board b( "8/4k3/8/4K3/4P3/8/8/8 w - - 0 1" );
+    PieceValidMoves g;
+    g.generateValidMoves( b );
+
+    REQUIRE( s.getBestMove( b, 4 ).score == 0 );
+}
@@ -1,6 +1,10 @@
 #include <iostream>
 
 #include "Board.h"
+#include "Evaluation.h"
+#include "Material.h"
+#include "Movegen.h"
+#include "catch2/benchmark/catch_benchmark.hpp"
 #include "catch2/catch_test_macros.hpp"
 
 /* ------------------------------ Constructors ------------------------------ */
@@ -27,7 +31,10 @@ TEST_CASE( "Board constructs correct starting position by default", "[Board::Boa
     REQUIRE( board.whiteIsCheckMated == false );
     REQUIRE( board.blackIsCheckMated == false );
     REQUIRE( board.staleMate == false );
-    REQUIRE( board.score == 0 );
+    REQUIRE( board.score[MIDDLE_GAME] == 0 );
+    REQUIRE( board.score[END_GAME] == 0 );
+    REQUIRE( MaterialTable::pieceCount( board.materialKey, WHITE, PAWN ) == 8 );
+    REQUIRE( MaterialTable::pieceCount( board.materialKey, BLACK, QUEEN ) == 1 );
 }
 
 /* ----------------------------- Board::Validate ---------------------------- */
@@ -179,3 +186,146 @@ TEST_CASE( "Pieces are moved correctly", "[Board::makeMove()]" ) {
     REQUIRE( board.squares[6] == std::nullopt );
     REQUIRE( board.squares[21]->type == KNIGHT );
 }
+
+TEST_CASE( "Fifty-move rule draws the game after 100 plies without a capture or a pawn move", "[Board::makeMove()]" ) {
+    Board board;
+    board.makeMove( 52, 36 );
+    REQUIRE( board.halfMoveClock() == 0 );
+
+    // Knights go back and forth
+    const std::array<std::pair<SquareIndex, SquareIndex>, 4> moves = {
+        { { 6, 21 }, { 62, 45 }, { 21, 6 }, { 45, 62 } } };
+    for ( int ply = 0; ply < 99; ply++ ) {
+        board.makeMove( moves[ply % 4].first, moves[ply % 4].second );
+    }
+    REQUIRE( board.halfMoveClock() == 99 );
+    REQUIRE( board.staleMate == false );
+
+    board.makeMove( moves[99 % 4].first, moves[99 % 4].second );
+    REQUIRE( board.halfMoveClock() == 100 );
+    REQUIRE( board.staleMate == true );
+
+    // Clock read from the FEN above the limit draws the game as well
+    board = Board( "4k3/8/8/8/8/8/8/R3K2R w - - 120 80" );
+    board.makeMove( 56, 48 );
+    REQUIRE( board.staleMate == true );
+}
+
+static bool scoreMatchesRecalculation( const Board &board ) {
+    return board.score[MIDDLE_GAME] == Evaluation::computeScore( board, MIDDLE_GAME ) &&
+           board.score[END_GAME] == Evaluation::computeScore( board, END_GAME ) &&
+           board.materialKey == Evaluation::computeMaterialKey( board ) &&
+           board.pawnKey == Evaluation::computePawnKey( board ) &&
+           board.kingSquares == Evaluation::findKingSquares( board );
+}
+
+TEST_CASE( "Score is updated incrementally by makeMove", "[Board::makeMove()]" ) {
+    Board board;
+    // Capture and en passant
+    for ( auto move : { "e2e4", "d7d5", "e4d5", "c7c5", "d5c6", "b7c6" } ) {
+        board.makeMove( move );
+        REQUIRE( scoreMatchesRecalculation( board ) );
+    }
+    // Castling
+    board = Board( "r3k2r/pppppppp/8/8/8/8/PPPPPPPP/R3K2R w KQkq - 0 1" );
+    for ( auto move : { "e1g1", "e8c8" } ) {
+        board.makeMove( move );
+        REQUIRE( scoreMatchesRecalculation( board ) );
+    }
+    // Promotion with capture
+    board = Board( "1n2k3/P7/8/8/8/8/8/4K3 w - - 0 1" );
+    board.makeMove( "a7b8q" );
+    REQUIRE( scoreMatchesRecalculation( board ) );
+    REQUIRE( MaterialTable::pieceCount( board.materialKey, WHITE, PAWN ) == 0 );
+    REQUIRE( MaterialTable::pieceCount( board.materialKey, WHITE, QUEEN ) == 1 );
+    REQUIRE( MaterialTable::pieceCount( board.materialKey, BLACK, KNIGHT ) == 0 );
+}
+
+/* ------------------------------ FEN notation ------------------------------ */
+
+TEST_CASE( "FEN is written back unchanged", "[Board::toFEN()]" ) {
+    REQUIRE( Board().toFEN() == "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1" );
+    for ( auto fen : { "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+                       "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w Kq - 3 17",
+                       "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 0", "4k3/8/8/8/8/8/8/R3K2R b Q - 99 120" } ) {
+        Board board( fen );
+        REQUIRE( board.toFEN() == fen );
+
+        char buffer[FEN_BUFFER_SIZE];
+        const char *end = board.toFEN( buffer );
+        REQUIRE( std::string_view( buffer, end - buffer ) == fen );
+        REQUIRE( *end == '\0' );
+    }
+}
+
+TEST_CASE( "FEN follows the moves made", "[Board::toFEN()]" ) {
+    Board board;
+    for ( auto move : { "e2e4", "e7e5", "g1f3", "e8e7" } ) {
+        board.makeMove( move );
+    }
+    REQUIRE( board.toFEN() == "rnbq1bnr/ppppkppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQ - 2 3" );
+    board.makeMove( "h1g1" );
+    REQUIRE( board.toFEN() == "rnbq1bnr/ppppkppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKBR1 b Q - 3 3" );
+}
+
+TEST_CASE( "Missing castling rights prevent castling", "[Board::parseFEN()]" ) {
+    PieceValidMoves generator;
+    Board board( "r3k2r/8/8/8/8/8/8/R3K2R w Kq - 0 1" );
+    generator.generateValidMoves( board );
+    const auto &whiteKing = board.squares[60]->validMoves;
+    REQUIRE( std::count( whiteKing.cbegin(), whiteKing.cend(), 62 ) == 1 );
+    REQUIRE( std::count( whiteKing.cbegin(), whiteKing.cend(), 58 ) == 0 );
+
+    board.makeMove( "a1b1" );
+    generator.generateValidMoves( board );
+    const auto &blackKing = board.squares[4]->validMoves;
+    REQUIRE( std::count( blackKing.cbegin(), blackKing.cend(), 2 ) == 1 );
+    REQUIRE( std::count( blackKing.cbegin(), blackKing.cend(), 6 ) == 0 );
+}
+
+TEST_CASE( "Invalid FEN fields are reported", "[Board::parseFEN()]" ) {
+    Board board;
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k w - - 0 1" ) == FEN_OK );
+    REQUIRE( board.kingSquares[WHITE] == 60 );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k b - d6 0 1" ) == FEN_OK );
+    REQUIRE( board.enPassantSquare == 19 );
+
+    REQUIRE( board.parseFEN( "" ) == FEN_INVALID_PIECE_PLACEMENT );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k3 w - - 0 1" ) == FEN_INVALID_PIECE_PLACEMENT );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8//4K2k w - - 0 1" ) == FEN_INVALID_PIECE_PLACEMENT );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/4K2k w - - 0 1" ) == FEN_INVALID_PIECE_PLACEMENT );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2x w - - 0 1" ) == FEN_INVALID_PIECE_PLACEMENT );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k x - - 0 1" ) == FEN_INVALID_SIDE_TO_MOVE );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k w K - 0 1" ) == FEN_INVALID_CASTLING_RIGHTS );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k w X - 0 1" ) == FEN_INVALID_CASTLING_RIGHTS );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k w - e4 0 1" ) == FEN_INVALID_EN_PASSANT );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k w - - -1 1" ) == FEN_INVALID_HALF_MOVE_CLOCK );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k w - - 0" ) == FEN_INVALID_FULL_MOVE_NUMBER );
+    REQUIRE( board.parseFEN( "8/8/8/8/8/8/8/4K2k w - - 0 1 x" ) == FEN_INVALID_FULL_MOVE_NUMBER );
+
+    REQUIRE_THROWS_AS( Board( "8/8/8/8/8/8/8/4K2k w K - 0 1" ), std::invalid_argument );
+}
+
+TEST_CASE( "FEN benchmark", "[Board::parseFEN()]" ) {
+    const std::string_view fens[] = { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                                      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                                      "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10" };
+    Board board;
+    char buffer[FEN_BUFFER_SIZE];
+
+    BENCHMARK( "Parse 1000 FENs" ) {
+        int errors = 0;
+        for ( int i = 0; i < 1000; i++ ) {
+            errors += board.parseFEN( fens[i % 4] ) != FEN_OK;
+        }
+        return errors;
+    };
+    BENCHMARK( "Write 1000 FENs" ) {
+        std::size_t length = 0;
+        for ( int i = 0; i < 1000; i++ ) {
+            length += board.toFEN( buffer ) - buffer;
+        }
+        return length;
+    };
+}
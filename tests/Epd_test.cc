@@ -0,0 +1,76 @@
+#include <sstream>
+
+#include "Epd.h"
+#include "Movegen.h"
+#include "catch2/catch_test_macros.hpp"
+
+/* --------------------------------- Parsing -------------------------------- */
+
+TEST_CASE( "EPD operations are parsed", "[EpdSuite.parse]" ) {
+    auto position = EpdSuite::parse( "7k/8/7K/8/8/8/8/5R2 w - - bm Rf8+; id \"stalemate trap\"; hmvc 51; fmvn 142;" );
+    REQUIRE( position.fen == "7k/8/7K/8/8/8/8/5R2 w - - 51 142" );
+    REQUIRE( position.id == "stalemate trap" );
+    REQUIRE( position.bestMoves == std::vector<std::string>{ "Rf8+" } );
+    REQUIRE( position.avoidMoves.empty() );
+
+    position = EpdSuite::parse( "k4K2/8/8/3q4/8/1R3N1P/8/8 b - - 0 1 am Qxf3 Qd6;" );
+    REQUIRE( position.fen == "k4K2/8/8/3q4/8/1R3N1P/8/8 b - - 0 1" );
+    REQUIRE( position.avoidMoves == std::vector<std::string>{ "Qxf3", "Qd6" } );
+
+    REQUIRE_THROWS( EpdSuite::parse( "8/8/8 w - - bm e4;" ) );
+
+    std::istringstream file( "# comment\n\n7k/8/7K/8/8/8/8/5R2 w - - bm Rf8+;\n" );
+    const EpdSuite suite( file );
+    REQUIRE( suite.positions().size() == 1 );
+    REQUIRE( suite.positions()[0].id == "3" );
+}
+
+TEST_CASE( "SAN and UCI notations are matched against moves", "[EpdSuite.matchesMove]" ) {
+    Board board( "r3k2r/1P6/8/8/8/2N3N1/8/R3K2R w KQkq - 0 1" );
+    PieceValidMoves generator;
+    generator.generateValidMoves( board );
+
+    REQUIRE( EpdSuite::matchesMove( board, MoveContent( 60, 62 ), "O-O" ) );
+    REQUIRE( EpdSuite::matchesMove( board, MoveContent( 60, 58 ), "O-O-O+" ) );
+    REQUIRE_FALSE( EpdSuite::matchesMove( board, MoveContent( 60, 62 ), "O-O-O" ) );
+    REQUIRE( EpdSuite::matchesMove( board, MoveContent( 42, 36 ), "Nce4" ) );
+    REQUIRE_FALSE( EpdSuite::matchesMove( board, MoveContent( 46, 36 ), "Nce4" ) );
+    REQUIRE( EpdSuite::matchesMove( board, MoveContent( 56, 0 ), "Rxa8+" ) );
+    REQUIRE( EpdSuite::matchesMove( board, MoveContent( 56, 0 ), "a1a8" ) );
+
+    MoveContent promotion( 9, 0 );
+    promotion.promotion = QUEEN;
+    REQUIRE( EpdSuite::matchesMove( board, promotion, "bxa8=Q+" ) );
+    REQUIRE( EpdSuite::matchesMove( board, promotion, "b7a8q" ) );
+    REQUIRE_FALSE( EpdSuite::matchesMove( board, promotion, "bxa8=N" ) );
+}
+
+/* --------------------------------- Running -------------------------------- */
+
+TEST_CASE( "EPD suite is solved by a pool of threads", "[EpdSuite.run]" ) {
+    std::istringstream file( "7k/8/7K/8/8/8/8/5R2 w - - 51 142 bm Rf8#; id \"Don't stalemate if you can win\";\n"
+                             "kn6/nn3r2/8/8/2p2Q2/8/NN6/KN6 w - - bm Qxf7; id \"Capture the rook\";\n"
+                             "k4K2/8/8/3q4/8/1R3N1P/8/8 b - - bm Qxb3; id \"Black captures the rook\";\n"
+                             "8/3R4/3p4/3P4/1K4Q1/8/7k/8 w - - 97 104 bm Rh7#; id \"Find the quickest mate\";\n"
+                             "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - am Kf1; bm Ra8#; id \"Back rank mate\";\n" );
+    const EpdSuite suite( file );
+
+    SearchLimits limits;
+    limits.depth = 3;
+    const auto report = suite.run( limits, 2 );
+
+    REQUIRE( report.results.size() == 5 );
+    REQUIRE( report.solved == 5 );
+    REQUIRE( report.results[1].id == "Capture the rook" );
+    REQUIRE( report.results[1].move == MoveContent( 37, 13 ) );
+    for ( const auto &result : report.results ) {
+        REQUIRE( result.timeToSolution >= 0 );
+        REQUIRE( result.nodesToSolution > 0 );
+        REQUIRE( result.nodes >= uint64_t( result.nodesToSolution ) );
+    }
+    REQUIRE( report.nodes > 0 );
+
+    std::ostringstream out;
+    EpdSuite::printReport( report, out );
+    REQUIRE( out.str().find( "Solved 5 of 5 positions" ) != std::string::npos );
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include "Evaluation.h"
+#include "Material.h"
 #include "catch2/catch_test_macros.hpp"
 
 /* ------------------------------ Constructors ------------------------------ */
@@ -9,3 +10,49 @@ TEST_CASE( "Evaluation of the board in initial position is 0", "[Evaluation.eval
     Board b;
     std::cout << Evaluation::evaluateBoard( b );
 }
+
+TEST_CASE( "Evaluation interpolates between middle game and end game scores", "[Evaluation.evaluate]" ) {
+    Board b( "4k3/4p3/8/8/8/8/3PP3/4K3 w - - 0 1" );
+    REQUIRE( MaterialTable::getInstance().probe( b.materialKey ).phase == 0 );
+    REQUIRE( Evaluation::evaluateBoard( b ) == b.score[END_GAME] + Evaluation::probePawnStructure( b ).score[END_GAME] );
+
+    b = Board();
+    REQUIRE( MaterialTable::getInstance().probe( b.materialKey ).phase == TOTAL_PHASE );
+    REQUIRE( Evaluation::evaluateBoard( b ) == b.score[MIDDLE_GAME] );
+}
+
+/* ----------------------------- Pawn structure ----------------------------- */
+
+TEST_CASE( "Pawn structure evaluation recognizes passed, doubled and isolated pawns", "[Evaluation.pawns]" ) {
+    // White: isolated passed pawns on d5 and h3, doubled pawn on h2. Black: passed pawns on a7 and b7.
+    Board b( "4k3/pp6/8/3P4/8/7P/7P/4K3 w - - 0 1" );
+    const PawnEntry &entry = Evaluation::probePawnStructure( b );
+
+    REQUIRE( entry.passedPawns[WHITE] == ( ( 1ULL << 27 ) | ( 1ULL << 47 ) ) );
+    REQUIRE( entry.passedPawns[BLACK] == ( ( 1ULL << 8 ) | ( 1ULL << 9 ) ) );
+    REQUIRE( entry.pawns[WHITE] == ( ( 1ULL << 27 ) | ( 1ULL << 47 ) | ( 1ULL << 55 ) ) );
+    REQUIRE( entry.pawnAttacks[BLACK] == ( ( 1ULL << 16 ) | ( 1ULL << 17 ) | ( 1ULL << 18 ) ) );
+
+    const int expectedEndGame = PASSED_PAWN_BONUS[END_GAME][4] + PASSED_PAWN_BONUS[END_GAME][2] -
+                                DOUBLED_PAWN_PENALTY[END_GAME] - 3 * ISOLATED_PAWN_PENALTY[END_GAME] -
+                                2 * PASSED_PAWN_BONUS[END_GAME][1];
+    REQUIRE( entry.score[END_GAME] == expectedEndGame );
+}
+
+TEST_CASE( "Pawn structure is served from the pawn hash table", "[Evaluation.pawns]" ) {
+    PawnHashTable &table = Evaluation::getPawnHashTable();
+    table.clear();
+
+    Board b;
+    b.makeMove( "g1f3" );
+    Evaluation::evaluateBoard( b );
+    b.makeMove( "g8f6" );
+    Evaluation::evaluateBoard( b );
+    b.makeMove( "b1c3" );
+    Evaluation::evaluateBoard( b );
+
+    REQUIRE( table.probes() == 3 );
+    REQUIRE( table.hits() == 2 );
+    // Knight moves keep the pawn structure, a single entry is filled
+    REQUIRE( table.usage() * table.size() == 1.0 );
+}
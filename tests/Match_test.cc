@@ -0,0 +1,99 @@
+#include <cmath>
+
+#include "Match.h"
+#include "catch2/catch_test_macros.hpp"
+
+static MatchPlayer depthPlayer( int depth ) {
+    MatchPlayer player;
+    player.name = "depth " + std::to_string( depth );
+    player.limits.depth = depth;
+    return player;
+}
+
+/* --------------------------------- Results -------------------------------- */
+
+TEST_CASE( "Match report estimates Elo and its error", "[Match.makeReport]" ) {
+    MatchOptions options;
+    auto report = Match::makeReport( 50, 0, 50, options );
+    REQUIRE( std::abs( report.elo ) < 1e-9 );
+    REQUIRE( report.eloError > 60 );
+    REQUIRE( report.eloError < 80 );
+
+    // Score 75% is 191 Elo
+    report = Match::makeReport( 60, 30, 10, options );
+    REQUIRE( std::abs( report.elo - 190.85 ) < 0.01 );
+    REQUIRE( Match::makeReport( 600, 300, 100, options ).eloError < report.eloError );
+    REQUIRE( Match::makeReport( 0, 0, 0, options ).elo == 0.0 );
+    REQUIRE( std::isfinite( Match::makeReport( 10, 0, 0, options ).elo ) );
+}
+
+TEST_CASE( "SPRT accepts the hypothesis closer to the results", "[Match.makeReport]" ) {
+    MatchOptions options;
+    options.elo0 = 0;
+    options.elo1 = 10;
+    auto report = Match::makeReport( 0, 0, 0, options );
+    REQUIRE( std::abs( report.upperBound - 2.944 ) < 0.001 );
+    REQUIRE( std::abs( report.lowerBound + 2.944 ) < 0.001 );
+    REQUIRE( report.sprtResult == 0 );
+
+    REQUIRE( Match::makeReport( 10, 10, 10, options ).sprtResult == 0 );
+    REQUIRE( Match::makeReport( 500, 1000, 300, options ).sprtResult == 1 );
+    REQUIRE( Match::makeReport( 300, 1000, 500, options ).sprtResult == -1 );
+    REQUIRE( Match::makeReport( 40, 20, 10, options ).llr > 0 );
+    REQUIRE( Match::makeReport( 30, 0, 0, options ).sprtResult == 1 );
+}
+
+/* --------------------------------- Playing -------------------------------- */
+
+TEST_CASE( "Games end with mates and draws", "[Match.playGame]" ) {
+    const MatchPlayer player = depthPlayer( 2 );
+    const Match match( player, player, {}, MatchOptions() );
+    Search whiteSearch, blackSearch;
+
+    // Mate in one
+    REQUIRE( match.playGame( "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", player, player, whiteSearch, blackSearch ) == 1 );
+    REQUIRE( match.playGame( "r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1", player, player, whiteSearch, blackSearch ) == -1 );
+    // Already mated and stalemated
+    REQUIRE( match.playGame( "R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1", player, player, whiteSearch, blackSearch ) == 1 );
+    REQUIRE( match.playGame( "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", player, player, whiteSearch, blackSearch ) == 0 );
+    // Insufficient material
+    REQUIRE( match.playGame( "8/8/4k3/8/8/3NK3/8/8 w - - 0 1", player, player, whiteSearch, blackSearch ) == 0 );
+    REQUIRE( match.playGame( "8/8/4k3/8/8/2NNK3/8/8 w - - 0 1", player, player, whiteSearch, blackSearch ) == 0 );
+    // Knight against bishop is not a dead position, the mate counts
+    REQUIRE( match.playGame( "k1K5/b1N5/8/8/8/8/8/8 b - - 0 1", player, player, whiteSearch, blackSearch ) == 1 );
+}
+
+TEST_CASE( "Games are drawn by the fifty-move rule", "[Match.playGame]" ) {
+    const MatchPlayer player = depthPlayer( 1 );
+    const Match match( player, player, {}, MatchOptions() );
+    Search whiteSearch, blackSearch;
+
+    REQUIRE( match.playGame( "4k3/8/8/8/8/8/8/R3K2R w - - 100 80", player, player, whiteSearch, blackSearch ) == 0 );
+    REQUIRE( match.playGame( "4k3/8/8/8/8/8/8/R3K2R w - - 120 80", player, player, whiteSearch, blackSearch ) == 0 );
+}
+
+TEST_CASE( "Games are drawn by the move limit", "[Match.playGame]" ) {
+    const MatchPlayer player = depthPlayer( 1 );
+    MatchOptions options;
+    options.maxMoves = 3;
+    const Match match( player, player, {}, options );
+    Search whiteSearch, blackSearch;
+    REQUIRE( match.playGame( Board().toFEN(), player, player, whiteSearch, blackSearch ) == 0 );
+}
+
+TEST_CASE( "Match plays both colours of every opening", "[Match.run]" ) {
+    MatchOptions options;
+    options.games = 4;
+    options.concurrency = 2;
+    options.maxMoves = 10;
+    // White mates at once, so each player wins the game it starts as white
+    const std::vector<std::string> openings = { "r5k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1" };
+    const Match match( depthPlayer( 2 ), depthPlayer( 2 ), openings, options );
+
+    int reports = 0;
+    const MatchReport report = match.run( [&]( const MatchReport& ) { reports++; } );
+    REQUIRE( reports == 4 );
+    REQUIRE( report.wins == 2 );
+    REQUIRE( report.losses == 2 );
+    REQUIRE( report.draws == 0 );
+}
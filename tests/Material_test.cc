@@ -0,0 +1,92 @@
+#include "Endgame.h"
+#include "Evaluation.h"
+#include "Material.h"
+#include "Search.h"
+#include "catch2/catch_test_macros.hpp"
+
+/* ------------------------------ Material key ------------------------------ */
+
+TEST_CASE( "Material key counts pieces of both colors", "[MaterialTable.materialKey]" ) {
+    Board b;
+    for ( PieceColor color : { WHITE, BLACK } ) {
+        REQUIRE( MaterialTable::pieceCount( b.materialKey, color, PAWN ) == 8 );
+        REQUIRE( MaterialTable::pieceCount( b.materialKey, color, KNIGHT ) == 2 );
+        REQUIRE( MaterialTable::pieceCount( b.materialKey, color, BISHOP ) == 2 );
+        REQUIRE( MaterialTable::pieceCount( b.materialKey, color, ROOK ) == 2 );
+        REQUIRE( MaterialTable::pieceCount( b.materialKey, color, QUEEN ) == 1 );
+    }
+
+    const MaterialEntry &entry = MaterialTable::getInstance().probe( b.materialKey );
+    REQUIRE( entry.phase == TOTAL_PHASE );
+    REQUIRE( entry.imbalance == 0 );
+    REQUIRE( entry.knownDraw == false );
+    REQUIRE( entry.endgame == nullptr );
+}
+
+TEST_CASE( "Material out of the table limits is calculated on demand", "[MaterialTable.probe]" ) {
+    // Three white queens
+    Board b( "4k3/8/8/8/8/8/8/QQQ1K3 w - - 0 1" );
+    const MaterialEntry &entry = MaterialTable::getInstance().probe( b.materialKey );
+    REQUIRE( entry.phase == 3 * QUEEN_PHASE );
+    REQUIRE( entry.strongSide == WHITE );
+    REQUIRE( entry.endgame == Endgame::evaluateKXK );
+}
+
+/* ------------------------------- Known draws ------------------------------ */
+
+TEST_CASE( "Material table recognizes insufficient material", "[MaterialTable.knownDraw]" ) {
+    MaterialTable &table = MaterialTable::getInstance();
+
+    REQUIRE( table.probe( Board( "4k3/8/8/8/8/8/8/4K3 w - - 0 1" ).materialKey ).knownDraw );
+    REQUIRE( table.probe( Board( "4k3/8/8/8/8/8/8/2B1K3 w - - 0 1" ).materialKey ).knownDraw );
+    REQUIRE( table.probe( Board( "4k3/8/8/8/8/8/8/1N2K3 w - - 0 1" ).materialKey ).knownDraw );
+    REQUIRE( table.probe( Board( "4k3/8/8/8/8/8/8/1N2KN2 w - - 0 1" ).materialKey ).knownDraw );
+    REQUIRE( table.probe( Board( "2b1k3/8/8/8/8/8/8/1N2K3 w - - 0 1" ).materialKey ).knownDraw );
+
+    REQUIRE_FALSE( table.probe( Board( "4k3/8/8/8/8/8/8/4K2R w - - 0 1" ).materialKey ).knownDraw );
+    REQUIRE_FALSE( table.probe( Board( "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1" ).materialKey ).knownDraw );
+    REQUIRE_FALSE( table.probe( Board( "4k3/8/8/8/8/8/8/1NB1K3 w - - 0 1" ).materialKey ).knownDraw );
+}
+
+TEST_CASE( "Search scores insufficient material as a draw", "[MaterialTable.knownDraw]" ) {
+    Search s;
+    Board b( "4k3/8/8/8/8/8/8/2B1K3 w - - 0 1" );
+    PieceValidMoves g;
+    g.generateValidMoves( b );
+
+    REQUIRE( Evaluation::evaluateBoard( b ) == 0 );
+    REQUIRE( s.getBestMove( b, 3 ).score == 0 );
+}
+
+/* -------------------------- Specialized endgames -------------------------- */
+
+TEST_CASE( "Material table selects specialized endgames", "[MaterialTable.endgame]" ) {
+    MaterialTable &table = MaterialTable::getInstance();
+
+    const MaterialEntry &krk = table.probe( Board( "4k3/8/8/8/8/8/8/4K2R w - - 0 1" ).materialKey );
+    REQUIRE( krk.endgame == Endgame::evaluateKXK );
+    REQUIRE( krk.strongSide == WHITE );
+
+    const MaterialEntry &kbnk = table.probe( Board( "1nb1k3/8/8/8/8/8/8/4K3 w - - 0 1" ).materialKey );
+    REQUIRE( kbnk.endgame == Endgame::evaluateKBNK );
+    REQUIRE( kbnk.strongSide == BLACK );
+
+    const MaterialEntry &kpk = table.probe( Board( "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1" ).materialKey );
+    REQUIRE( kpk.endgame == Endgame::evaluateKPK );
+
+    REQUIRE( table.probe( Board( "4k3/4p3/8/8/8/8/4P3/4K3 w - - 0 1" ).materialKey ).endgame == nullptr );
+}
+
+TEST_CASE( "Specialized endgames drive the losing king", "[Endgame]" ) {
+    // Losing king in the corner scores better than in the center
+    REQUIRE( Endgame::evaluateKXK( Board( "7k/8/5K2/8/8/8/8/R7 w - - 0 1" ), WHITE ) >
+             Endgame::evaluateKXK( Board( "8/8/8/4k3/8/2K5/8/R7 w - - 0 1" ), WHITE ) );
+
+    // Dark squared bishop mates in a1 or h8
+    REQUIRE( Endgame::evaluateKBNK( Board( "7k/8/5KN1/8/8/8/8/2B5 w - - 0 1" ), WHITE ) >
+             Endgame::evaluateKBNK( Board( "k7/8/1K1N4/8/8/8/8/2B5 w - - 0 1" ), WHITE ) );
+
+    // Black king cannot catch the pawn
+    REQUIRE( Endgame::evaluateKPK( Board( "7k/8/8/8/P7/8/8/4K3 w - - 0 1" ), WHITE ) > KNOWN_WIN_BONUS );
+    REQUIRE( Endgame::evaluateKPK( Board( "1k6/8/8/8/P7/8/8/4K3 w - - 0 1" ), WHITE ) < KNOWN_WIN_BONUS );
+}
@@ -1,4 +1,6 @@
+#include "Board.h"
 #include "MoveContent.h"
+#include "Movegen.h"
 #include "catch2/catch_test_macros.hpp"
 
 TEST_CASE( "Move constructor assigns correct values", "[MoveContent::MoveContent]" ) {
@@ -10,5 +12,11 @@ TEST_CASE( "Move constructor assigns correct values", "[MoveContent::MoveContent
     REQUIRE( move.pieceTaken == EMPTY );
     REQUIRE( move.isEnPassantCapture == false );
     REQUIRE( move.score == 0 );
-    REQUIRE( move.toPGN() == "O-O-O" );
+}
+
+TEST_CASE( "Move is written in standard algebraic notation", "[MoveContent::toPGN]" ) {
+    Board board( "r3k3/8/8/8/8/8/8/R3K3 w Qq - 0 1" );
+    PieceValidMoves generator;
+    generator.generateValidMoves( board );
+    REQUIRE( MoveContent( 60, 58 ).toPGN( board ) == "O-O-O" );
 }
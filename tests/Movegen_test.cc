@@ -2,66 +2,14 @@
 
 #include "Engine.h"
 #include "Movegen.h"
+#include "Perft.h"
 #include "catch2/benchmark/catch_benchmark.hpp"
 #include "catch2/catch_test_macros.hpp"
 
 /* ---------------------------------- Perft --------------------------------- */
 
 uint64_t perft( int depth, Board &board, PieceValidMoves &generator ) {
-    if ( depth == 0 ) {
-        return 1;
-    }
-
-    uint64_t nodes = 0;
-
-    // Cache the board
-    Board currentBoard( board );
-
-    // Iterate through every piece on the board
-    for ( SquareIndex srcSquare = 0; srcSquare < 64; srcSquare++ ) {
-        const auto piece = board.squares[srcSquare];
-
-        if ( piece == std::nullopt || piece->color != board.sideToMove ) {
-            continue;
-        }
-
-        // Iterate through every pseudo valid move for the piece
-        for ( auto destSquare : piece->validMoves ) {
-            // For pawn promotions
-            if ( piece->type == PAWN && ( destSquare < 8 || destSquare > 55 ) ) {
-                for ( PieceType promotionType : { KNIGHT, BISHOP, ROOK, QUEEN } ) {
-                    // Make the move
-                    board.makeMove( srcSquare, destSquare, promotionType );
-                    generator.generateValidMoves( board );
-
-                    // Add subnodes count if the move is valid
-                    if ( generator.validateBoard( board ) == true ) {
-                        nodes += perft( depth - 1, board, generator );
-                    }
-
-                    // Undo the move
-                    board = currentBoard;
-                }
-                continue;
-            }
-            // For rest of the moves
-            else {
-                // Make the move
-                board.makeMove( srcSquare, destSquare );
-                generator.generateValidMoves( board );
-
-                // Add subnodes count if the move is valid
-                if ( generator.validateBoard( board ) == true ) {
-                    nodes += perft( depth - 1, board, generator );
-                }
-
-                // Undo the move
-                board = currentBoard;
-            }
-        }
-    }
-
-    return nodes;
+    return Perft::count( board, depth, generator );
 }
 
 /* -------------------- benchmarks from starting position ------------------- */
@@ -0,0 +1,41 @@
+#include <sstream>
+
+#include "Evaluation.h"
+#include "PerfCounters.h"
+#include "catch2/catch_test_macros.hpp"
+
+TEST_CASE( "Unavailable counters are reported", "[PerfCounters]" ) {
+    PerfReading reading;
+    REQUIRE_FALSE( reading.isAvailable() );
+    REQUIRE( reading.ipc() == 0.0 );
+
+    std::ostringstream out;
+    PerfCounters::printReport( reading, 1000, out );
+    REQUIRE( out.str() == "Hardware counters unavailable\n" );
+
+    reading.values[PERF_CYCLES] = 2000;
+    reading.available[PERF_CYCLES] = true;
+    out.str( "" );
+    PerfCounters::printReport( reading, 1000, out );
+    REQUIRE( out.str().find( "cycles 2.00/node" ) != std::string::npos );
+    REQUIRE( out.str().find( "instructions unavailable" ) != std::string::npos );
+}
+
+TEST_CASE( "Counters measure the evaluation where they are available", "[PerfCounters]" ) {
+    PerfCounters counters;
+    counters.start();
+    int score = 0;
+    for ( int i = 0; i < 1000; i++ ) {
+        score += Evaluation::evaluateBoard( Board() );
+    }
+    const PerfReading reading = counters.stop();
+
+    REQUIRE( score == 0 );
+    REQUIRE( reading.isAvailable() == counters.isAvailable() );
+    if ( reading.available[PERF_INSTRUCTIONS] ) {
+        REQUIRE( reading.values[PERF_INSTRUCTIONS] > 1000 );
+    }
+    if ( reading.available[PERF_CYCLES] && reading.available[PERF_INSTRUCTIONS] ) {
+        REQUIRE( reading.ipc() > 0.0 );
+    }
+}
@@ -0,0 +1,59 @@
+#include <sstream>
+
+#include "Perft.h"
+#include "catch2/catch_test_macros.hpp"
+
+/* --------------------------------- Counting ------------------------------- */
+
+TEST_CASE( "Perft counts edge case positions", "[Perft]" ) {
+    const std::vector<PerftPosition> positions = {
+        { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 3, 2812 },
+        { "castling-through-attack", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 2, 1141 },
+        { "promotion", "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1", 3, 9483 },
+        { "wrong", "8/8/8/8/8/8/8/K6k w - - 0 1", 1, 4 },
+    };
+    const PerftReport report = Perft::run( positions );
+    REQUIRE( report.results.size() == 4 );
+    REQUIRE( report.failed == 1 );
+    REQUIRE( report.results[0].nodes == 2812 );
+    REQUIRE( report.results[3].nodes == 3 );
+    REQUIRE( report.nodes == 2812 + 1141 + 9483 + 3 );
+}
+
+TEST_CASE( "Perft suite covers the reference positions", "[Perft]" ) {
+    REQUIRE( Perft::positions().size() >= 6 );
+    for ( const auto &position : Perft::positions() ) {
+        REQUIRE_NOTHROW( Board( position.fen ) );
+        REQUIRE( position.expected > 0 );
+    }
+}
+
+/* ---------------------------------- Files --------------------------------- */
+
+TEST_CASE( "Perft results are read back as the baseline", "[Perft]" ) {
+    const PerftReport report{
+        { { "first", 3, 100, 100, 1000, 100000 }, { "second", 4, 200, 200, 1000, 200000 } }, 0, 300, 2000, 150000 };
+    std::stringstream json;
+    Perft::writeJson( report, json );
+    const auto baseline = Perft::readBaseline( json );
+    REQUIRE( baseline.size() == 2 );
+    REQUIRE( baseline.at( "first" ) == 100000 );
+    REQUIRE( baseline.at( "second" ) == 200000 );
+
+    std::istringstream invalid( "{ \"name\": \"first\", \"depth\": 3 }" );
+    REQUIRE_THROWS_AS( Perft::readBaseline( invalid ), std::invalid_argument );
+}
+
+TEST_CASE( "Perft flags positions slower than the threshold", "[Perft]" ) {
+    const PerftReport report{
+        { { "first", 3, 100, 100, 1000, 85000 }, { "second", 4, 200, 200, 1000, 150000 }, { "new", 1, 1, 1, 1, 1 } },
+        0, 301, 2001, 150000 };
+    const std::map<std::string, uint64_t> baseline = { { "first", 100000 }, { "second", 200000 } };
+
+    auto regressions = Perft::compare( report, baseline, 20.0 );
+    REQUIRE( regressions.size() == 1 );
+    REQUIRE( regressions[0].name == "second" );
+    REQUIRE( regressions[0].change == -25.0 );
+    REQUIRE( Perft::compare( report, baseline, 10.0 ).size() == 2 );
+    REQUIRE( Perft::compare( report, baseline, 30.0 ).empty() );
+}
@@ -0,0 +1,160 @@
+#include <set>
+#include <sstream>
+
+#include "Movegen.h"
+#include "Pgn.h"
+#include "Search.h"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+static std::string toSan( const std::string &fen, const MoveContent &move ) {
+    Board board( fen );
+    PieceValidMoves generator;
+    generator.generateValidMoves( board );
+    return move.toPGN( board );
+}
+
+/* ----------------------------------- SAN ---------------------------------- */
+
+TEST_CASE( "SAN of the moves is written with disambiguation and suffixes", "[MoveContent.toPGN]" ) {
+    REQUIRE( toSan( "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", MoveContent( 52, 36 ) ) == "e4" );
+    REQUIRE( toSan( "k7/8/8/8/8/8/4K3/R6R w - - 0 1", MoveContent( 56, 59 ) ) == "Rad1" );
+    REQUIRE( toSan( "7k/8/8/R7/8/8/8/R3K3 w - - 0 1", MoveContent( 56, 40 ) ) == "R1a3" );
+    REQUIRE( toSan( "4k3/8/8/8/8/Q7/8/Q1Q4K w - - 0 1", MoveContent( 56, 49 ) ) == "Qa1b2" );
+    // Pinned knight on e2 cannot go to d4
+    REQUIRE( toSan( "k3r3/8/8/1N6/8/8/4N3/4K3 w - - 0 1", MoveContent( 25, 35 ) ) == "Nd4" );
+    REQUIRE( toSan( "4k3/1P6/8/8/8/8/8/4K3 w - - 0 1", MoveContent( 9, 1, QUEEN ) ) == "b8=Q+" );
+    // Promotion piece defaults to the queen
+    REQUIRE( toSan( "4k3/1P6/8/8/8/8/8/4K3 w - - 0 1", MoveContent( 9, 1 ) ) == "b8=Q+" );
+    REQUIRE( toSan( "4k3/1P6/8/8/8/8/8/4K3 w - - 0 1", MoveContent( 9, 1, KNIGHT ) ) == "b8=N" );
+    REQUIRE( toSan( "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", MoveContent( 56, 0 ) ) == "Ra8#" );
+    REQUIRE( toSan( "r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1", MoveContent( 4, 2 ) ) == "O-O-O" );
+
+    Board board( "4k3/3p4/8/4P3/8/8/8/4K3 b - - 0 1" );
+    board.makeMove( 11, 27 );
+    PieceValidMoves generator;
+    generator.generateValidMoves( board );
+    REQUIRE( MoveContent( 28, 19 ).toPGN( board ) == "exd6" );
+    REQUIRE( *MoveContent::fromPGN( board, "exd6" ) == MoveContent( 28, 19 ) );
+    REQUIRE( MoveContent::fromPGN( board, "exd6" )->isEnPassantCapture );
+}
+
+TEST_CASE( "SAN of every legal move is unique and parsed back", "[MoveContent.fromPGN]" ) {
+    Search search;
+    PieceValidMoves generator;
+    for ( const std::string fen : { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                                    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1" } ) {
+        Board board( fen );
+        generator.generateValidMoves( board );
+        std::set<std::string> sans;
+        for ( const auto &move : search.getPossibleMoves( board ) ) {
+            Board examineBoard = board;
+            examineBoard.makeMove( move.src, move.dest, move.promotion );
+            generator.generateValidMoves( examineBoard );
+            if ( !generator.validateBoard( examineBoard ) ) {
+                continue;
+            }
+
+            const std::string san = move.toPGN( board );
+            REQUIRE( sans.insert( san ).second );
+            const auto parsed = MoveContent::fromPGN( board, san );
+            REQUIRE( parsed );
+            REQUIRE( *parsed == move );
+        }
+    }
+
+    Board board;
+    generator.generateValidMoves( board );
+    REQUIRE_FALSE( MoveContent::fromPGN( board, "e5" ) );
+    REQUIRE_FALSE( MoveContent::fromPGN( board, "Ke2" ) );
+    REQUIRE( *MoveContent::fromPGN( board, "Nf3!?" ) == MoveContent( 62, 45 ) );
+}
+
+/* --------------------------------- Reader --------------------------------- */
+
+static const char *const PGN_GAMES = R"([Event "Test"]
+[White "A \"quoted\" name"]
+[Result "1-0"]
+
+1. e4 e5 2. Nf3 {develops (and attacks)} Nc6 (2... d6 3. d4 (3. Bc4) {side line} exd4) 3. Bb5 $1 a6 ; comment
+4.Ba4 Nf6 5. 0-0 Be7 1-0
+
+%escaped line
+[Event "Fool"]
+
+1. f3 e5 2. g4 Qh4# 0-1
+[Event "Unfinished"]
+[FEN "4k3/8/8/8/8/8/8/R3K3 w Q - 0 1"]
+
+1. O-O-O Ke7)";
+
+// Plays the main line of the game, returns the final position or nullopt if a move is illegal
+static std::optional<Board> playGame( const PgnGame &game ) {
+    Board board = game.startingBoard();
+    PieceValidMoves generator;
+    for ( const auto san : game.moves ) {
+        const auto move = MoveContent::fromPGN( board, san );
+        if ( !move ) {
+            return std::nullopt;
+        }
+        board.makeMove( move->src, move->dest, move->promotion );
+        generator.generateValidMoves( board );
+    }
+    return board;
+}
+
+TEST_CASE( "PGN games are read in chunks", "[PgnReader.next]" ) {
+    for ( std::size_t chunkSize : { std::size_t( 7 ), PGN_CHUNK_SIZE } ) {
+        std::istringstream in( PGN_GAMES );
+        PgnReader reader( in, chunkSize );
+        PgnGame game;
+
+        REQUIRE( reader.next( game ) );
+        REQUIRE( game.tag( "Event" ) == "Test" );
+        REQUIRE( game.tag( "White" ) == "A \\\"quoted\\\" name" );
+        REQUIRE( game.result == "1-0" );
+        REQUIRE( game.moves.size() == 10 );
+        REQUIRE( game.moves[8] == "0-0" );
+        auto board = playGame( game );
+        REQUIRE( board );
+        REQUIRE( board->squares[62]->type == KING );
+        REQUIRE( board->squares[61]->type == ROOK );
+
+        REQUIRE( reader.next( game ) );
+        REQUIRE( game.tag( "Event" ) == "Fool" );
+        REQUIRE( game.result == "0-1" );
+        board = playGame( game );
+        REQUIRE( board );
+        REQUIRE( board->squares[39]->type == QUEEN );
+
+        REQUIRE( reader.next( game ) );
+        REQUIRE( game.tag( "Event" ) == "Unfinished" );
+        REQUIRE( game.result.empty() );
+        board = playGame( game );
+        REQUIRE( board );
+        REQUIRE( board->squares[58]->type == KING );
+        REQUIRE( board->squares[12]->type == KING );
+
+        REQUIRE_FALSE( reader.next( game ) );
+    }
+}
+
+TEST_CASE( "PGN reader benchmark", "[PgnReader.next]" ) {
+    std::string games;
+    for ( int i = 0; i < 1000; i++ ) {
+        games += PGN_GAMES;
+        games += " *\n";
+    }
+
+    BENCHMARK( "Read 3000 games" ) {
+        std::istringstream in( games );
+        PgnReader reader( in );
+        PgnGame game;
+        int count = 0;
+        while ( reader.next( game ) ) {
+            count++;
+        }
+        return count;
+    };
+}
@@ -0,0 +1,118 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "Engine.h"
+#include "Polyglot.h"
+#include "catch2/catch_test_macros.hpp"
+
+// Polyglot move encoding, squares are given as file and rank starting from 0
+static uint16_t polyglotMove( int srcFile, int srcRank, int destFile, int destRank ) {
+    return ( ( srcRank * 8 + srcFile ) << 6 ) | ( destRank * 8 + destFile );
+}
+
+// Writes the book entries in the big endian Polyglot format, entries have to be sorted by key
+static std::string writeBook( const std::string &name, const std::vector<PolyglotEntry> &entries ) {
+    const std::string path = ( std::filesystem::temp_directory_path() / name ).string();
+    std::ofstream file( path, std::ios::binary );
+    for ( const auto &entry : entries ) {
+        for ( int shift = 56; shift >= 0; shift -= 8 ) file.put( char( entry.key >> shift ) );
+        for ( int shift = 8; shift >= 0; shift -= 8 ) file.put( char( entry.move >> shift ) );
+        for ( int shift = 8; shift >= 0; shift -= 8 ) file.put( char( entry.weight >> shift ) );
+        for ( int shift = 24; shift >= 0; shift -= 8 ) file.put( char( entry.learn >> shift ) );
+    }
+    return path;
+}
+
+/* ------------------------------ Polyglot keys ----------------------------- */
+
+TEST_CASE( "Polyglot keys match the reference values", "[OpeningBook.polyglotKey]" ) {
+    Board b;
+    REQUIRE( OpeningBook::polyglotKey( b ) == 0x463b96181691fc9cULL );
+
+    const std::pair<std::string, uint64_t> moves[] = {
+        { "e2e4", 0x823c9b50fd114196ULL }, { "d7d5", 0x0756b94461c50fb0ULL }, { "e4e5", 0x662fafb965db29d4ULL },
+        { "f7f5", 0x22a48b5a8e47ff78ULL }, { "e1e2", 0x652a607ca3f242c1ULL }, { "e8f7", 0x00fdd303c946bdd9ULL },
+    };
+    for ( const auto &[move, key] : moves ) {
+        b.makeMove( move );
+        REQUIRE( OpeningBook::polyglotKey( b ) == key );
+    }
+
+    b = Board();
+    const std::pair<std::string, uint64_t> otherMoves[] = {
+        { "a2a4", 0 }, { "b7b5", 0 }, { "h2h4", 0 }, { "b5b4", 0 }, { "c2c4", 0x3c8123ea7b067637ULL },
+        { "b4c3", 0 }, { "a1a3", 0x5c3f9b829b279560ULL },
+    };
+    for ( const auto &[move, key] : otherMoves ) {
+        b.makeMove( move );
+        if ( key != 0 ) {
+            REQUIRE( OpeningBook::polyglotKey( b ) == key );
+        }
+    }
+}
+
+/* ------------------------------ Book probing ------------------------------ */
+
+TEST_CASE( "Opening book finds weighted moves of the position", "[OpeningBook.probe]" ) {
+    const uint64_t startKey = OpeningBook::polyglotKey( Board() );
+    const std::vector<PolyglotEntry> entries = {
+        { 1, polyglotMove( 0, 1, 0, 2 ), 100, 0 },
+        { startKey, polyglotMove( 4, 1, 4, 3 ), 10, 0 },
+        { startKey, polyglotMove( 3, 1, 3, 3 ), 1, 0 },
+        { ~0ULL, polyglotMove( 7, 1, 7, 2 ), 100, 0 },
+    };
+    const std::string path = writeBook( "polyglot_test_probe.bin", entries );
+    OpeningBook book( path );
+    REQUIRE( book.size() == 4 );
+
+    Board b;
+    REQUIRE( book.getMoves( b ).size() == 2 );
+    auto move = book.probe( b, true );
+    REQUIRE( move );
+    REQUIRE( move->src == 52 );
+    REQUIRE( move->dest == 36 );
+    REQUIRE( move->pieceMoving == PAWN );
+
+    // Random pick is always one of the book moves
+    for ( int i = 0; i < 20; i++ ) {
+        move = book.probe( b );
+        REQUIRE( ( move->dest == 36 || move->dest == 35 ) );
+    }
+
+    b.makeMove( "e2e4" );
+    REQUIRE_FALSE( book.probe( b ) );
+    std::remove( path.c_str() );
+}
+
+TEST_CASE( "Opening book decodes castling as king move by two squares", "[OpeningBook.probe]" ) {
+    const Board b( "r3k2r/pppppppp/8/8/8/8/PPPPPPPP/R3K2R w KQkq - 0 1" );
+    // King side castling is encoded as e1h1
+    const PolyglotEntry castling = { OpeningBook::polyglotKey( b ), polyglotMove( 4, 0, 7, 0 ), 1, 0 };
+    const std::string path = writeBook( "polyglot_test_castling.bin", { castling } );
+    OpeningBook book( path );
+
+    auto move = book.probe( b );
+    REQUIRE( move );
+    REQUIRE( move->src == 60 );
+    REQUIRE( move->dest == 62 );
+    REQUIRE( move->pieceMoving == KING );
+    std::remove( path.c_str() );
+}
+
+TEST_CASE( "Opening book cannot be opened from missing file", "[OpeningBook.OpeningBook()]" ) {
+    REQUIRE_THROWS_AS( OpeningBook( "/nonexistent/book.bin" ), std::runtime_error );
+}
+
+TEST_CASE( "Engine plays book moves before searching", "[Engine.getBestMove]" ) {
+    const std::string path = writeBook( "polyglot_test_engine.bin",
+                                        { { OpeningBook::polyglotKey( Board() ), polyglotMove( 6, 0, 5, 2 ), 1, 0 } } );
+    Engine engine;
+    engine.loadOpeningBook( path );
+
+    auto move = engine.getBestMove( 3 );
+    REQUIRE( move.src == 62 );
+    REQUIRE( move.dest == 45 );
+    REQUIRE( engine.makeMove( move.src, move.dest ) );
+    std::remove( path.c_str() );
+}
@@ -0,0 +1,115 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "PositionFile.h"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+static const char *FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w Kq - 3 17",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "4k3/8/8/8/8/8/8/R3K2R b Q - 99 120",
+};
+
+static std::string tempPath( const std::string &name ) {
+    return ( std::filesystem::temp_directory_path() / name ).string();
+}
+
+/* ----------------------------- Packed position ---------------------------- */
+
+TEST_CASE( "Packed position restores the board", "[Board::pack()]" ) {
+    for ( auto fen : FENS ) {
+        const Board board( fen );
+        const PackedPosition position = board.pack( -35, 1 );
+        REQUIRE( position.score == -35 );
+        REQUIRE( position.result == 1 );
+
+        const Board unpacked( position );
+        REQUIRE( unpacked.toFEN() == fen );
+        REQUIRE( unpacked.score == board.score );
+        REQUIRE( unpacked.materialKey == board.materialKey );
+        REQUIRE( unpacked.pawnKey == board.pawnKey );
+        REQUIRE( unpacked.kingSquares == board.kingSquares );
+    }
+
+    const PackedPosition position = Board().pack();
+    REQUIRE( position.score == PackedPosition::NO_SCORE );
+    REQUIRE( position.result == PackedPosition::NO_RESULT );
+}
+
+TEST_CASE( "Packed position rejects invalid pieces", "[Board::pack()]" ) {
+    PackedPosition position = Board().pack();
+    position.pieces[0] = 0x77;
+    REQUIRE_THROWS_AS( Board( position ), std::invalid_argument );
+
+    const Board crowded( "qqqqqqqq/qqqqqqqq/qqqqqqqq/qqqqqqqq/8/8/8/K6k w - - 0 1" );
+    REQUIRE_THROWS_AS( crowded.pack(), std::invalid_argument );
+}
+
+/* ------------------------------ Position file ----------------------------- */
+
+TEST_CASE( "Position file reads back written positions", "[PositionFile]" ) {
+    const std::string path = tempPath( "position_file_test.bin" );
+    {
+        PositionWriter writer( path );
+        for ( int i = 0; i < 4; i++ ) {
+            writer.write( Board( FENS[i] ), i * 10, i % 3 - 1 );
+        }
+    }
+    {
+        PositionWriter writer( path, true );
+        writer.write( Board() );
+    }
+
+    PositionFile file( path );
+    REQUIRE( file.size() == 5 );
+    for ( int i = 0; i < 4; i++ ) {
+        REQUIRE( file.board( i ).toFEN() == FENS[i] );
+        REQUIRE( file[i].score == i * 10 );
+        REQUIRE( file[i].result == i % 3 - 1 );
+    }
+    REQUIRE( file.board( 4 ).toFEN() == Board().toFEN() );
+    REQUIRE( file.end() - file.begin() == 5 );
+    std::remove( path.c_str() );
+}
+
+TEST_CASE( "Position file rejects truncated files", "[PositionFile]" ) {
+    const std::string path = tempPath( "position_file_test_truncated.bin" );
+    std::ofstream( path, std::ios::binary ) << "truncated";
+    REQUIRE_THROWS_AS( PositionFile( path ), std::runtime_error );
+    std::remove( path.c_str() );
+
+    REQUIRE_THROWS_AS( PositionFile( tempPath( "position_file_test_missing.bin" ) ), std::runtime_error );
+    PositionWriter( path ).flush();
+    REQUIRE( PositionFile( path ).size() == 0 );
+    std::remove( path.c_str() );
+}
+
+TEST_CASE( "Position file benchmark", "[PositionFile]" ) {
+    const std::string path = tempPath( "position_file_test_benchmark.bin" );
+    {
+        PositionWriter writer( path );
+        for ( int i = 0; i < 1000; i++ ) {
+            writer.write( Board( FENS[i % 4] ) );
+        }
+    }
+    PositionFile file( path );
+
+    BENCHMARK( "Unpack 1000 positions" ) {
+        int kings = 0;
+        for ( const auto &position : file ) {
+            kings += Board( position ).kingSquares[WHITE];
+        }
+        return kings;
+    };
+    BENCHMARK( "Parse 1000 FENs" ) {
+        int kings = 0;
+        for ( int i = 0; i < 1000; i++ ) {
+            kings += Board( FENS[i % 4] ).kingSquares[WHITE];
+        }
+        return kings;
+    };
+    std::remove( path.c_str() );
+}
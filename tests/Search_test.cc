@@ -1,5 +1,6 @@
 #include <catch2/generators/catch_generators.hpp>
 
+#include "Engine.h"
 #include "Search.h"
 #include "catch2/benchmark/catch_benchmark.hpp"
 #include "catch2/catch_test_macros.hpp"
@@ -24,7 +25,7 @@ TEST_CASE( "Search finds the corect move for 1 ply fool's mate position for whit
     Board b( "r1bqkbnr/ppp2ppp/2np4/4p3/2B1P3/5Q2/PPPP1PPP/RNB1K1NR w KQkq - 0 2" );
     PieceValidMoves g;
     g.generateValidMoves( b );
-    auto bestMove = s.getBestMove( b, 5, b.sideToMove == WHITE );
+    auto bestMove = s.getBestMove( b, 5 );
     REQUIRE( bestMove.pieceMoving == QUEEN );
     REQUIRE( bestMove.src == 45 );
     REQUIRE( bestMove.dest == 13 );
@@ -44,75 +45,261 @@ TEST_CASE( "getBestMove multiple benchmarking", "[Search.getBestMove]" ) {
     PieceValidMoves g;
     g.generateValidMoves( b );
 
-    REQUIRE( s.getBestMove( b, depth, true ) == expected_result );
-    BENCHMARK( "getBestMove search at depth " + std::to_string( depth ) ) { return s.getBestMove( b, depth, true ); };
+    REQUIRE( s.getBestMove( b, depth ) == expected_result );
+    BENCHMARK( "getBestMove search at depth " + std::to_string( depth ) ) { return s.getBestMove( b, depth ); };
 }
 
-/* --------------------------------------------- testcases from internet -------------------------------------------- */
+/* -------------------------------- findMate -------------------------------- */
+TEST_CASE( "findMate proves mate in 1", "[Search.findMate]" ) {
+    Search s;
+    Board b( "r1bqkbnr/ppp2ppp/2np4/4p3/2B1P3/5Q2/PPPP1PPP/RNB1K1NR w KQkq - 0 2" );
+    PieceValidMoves g;
+    g.generateValidMoves( b );
+    auto line = s.findMate( b, 3 );
 
-TEST_CASE( "Don't stalemate if you can win", "[search]" ) {
-    // MagicMoves::initmagicmoves();
-    // Tables::init();
-    // ZK::initZobristKeys();
-    // globalTT.init_TT_size( TT::TEST_MB_SIZE );  // For tests TT size is TT_SIZE_DEFAULT
+    REQUIRE( line.size() == 1 );
+    REQUIRE( line[0] == MoveContent( 45, 13 ) );
+}
+
+TEST_CASE( "findMate proves mate in 2 with a knight sacrifice", "[Search.findMate]" ) {
+    Search s;
+    Board b( "r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 0" );
+    PieceValidMoves g;
+    g.generateValidMoves( b );
+    auto line = s.findMate( b, 3 );
+
+    REQUIRE( line.size() == 3 );
+    REQUIRE( line[0] == MoveContent( 27, 21 ) );  // Nf6+
+    REQUIRE( line[2] == MoveContent( 34, 13 ) );  // Bxf7#
+    BENCHMARK( "findMate mate in 2" ) { return s.findMate( b, 2 ); };
+}
+
+TEST_CASE( "findMate returns empty line when there is no forced mate", "[Search.findMate]" ) {
+    Search s;
+    Board b;
+    PieceValidMoves g;
+    g.generateValidMoves( b );
 
-    // std::shared_ptr<Board> sp = std::shared_ptr<Board>( new Board( "7k/8/7K/8/8/8/8/5R2 w - - 51 142" ) );
-    // Search search( sp );
-    // search.negaMaxRoot( 5 );
-    // Move move = search.myBestMove;
-    // REQUIRE( move.toShortString() == "f1f8" );
+    REQUIRE( s.findMate( b, 2 ).empty() );
+}
+
+/* --------------------------------------------- testcases from internet -------------------------------------------- */
 
+TEST_CASE( "Don't stalemate if you can win", "[search]" ) {
     Search s;
     Board b( "7k/8/7K/8/8/8/8/5R2 w - - 51 142" );
     PieceValidMoves g;
     g.generateValidMoves( b );
-    auto bestMove = s.getBestMove( b, 5, b.sideToMove == WHITE );
+    auto bestMove = s.getBestMove( b, 5 );
 
     REQUIRE( bestMove.src == 61 );
     REQUIRE( bestMove.dest == 5 );
 }
 
-// TEST_CASE( "Search", "[search]" ) {
-//     MagicMoves::initmagicmoves();
-//     Tables::init();
-//     ZK::initZobristKeys();
-//     globalTT.init_TT_size( TT::TEST_MB_SIZE );
-
-//     SECTION( "Test search depth 1 white" ) {
-//         std::shared_ptr<Board> sp = std::shared_ptr<Board>( new Board( "kn6/nn3r2/8/8/2p2Q2/8/NN6/KN6 w - -" ) );
-//         Search search( sp );
-//         search.negaMaxRoot( 1 );
-//         Move move = search.myBestMove;
-
-//         REQUIRE( move.toShortString() == "f4f7" );
-//     }
-
-//     SECTION( "Test search depth 1 black" ) {
-//         std::shared_ptr<Board> sp = std::shared_ptr<Board>( new Board( "k4K2/8/8/3q4/8/1R3N1P/8/8 b - -" ) );
-//         Search search( sp );
-//         search.negaMaxRoot( 1 );
-//         Move move = search.myBestMove;
-
-//         REQUIRE( move.toShortString() == "d5b3" );
-//     }
-
-//     SECTION( "Test search depth 2" ) {
-//         std::shared_ptr<Board> sp = std::shared_ptr<Board>( new Board( "kn6/nn2rr2/8/4Q3/8/2p1p2b/1Q6/KN6 w - -" ) );
-//         Search search( sp );
-//         search.negaMaxRoot( 2 );
-//         Move move = search.myBestMove;
-
-//         REQUIRE( move.toShortString() == "e5c3" );
-//     }
-
-//     SECTION( "Always find the quickest mate" ) {
-//         std::shared_ptr<Board> sp = std::shared_ptr<Board>( new Board( "8/3R4/3p4/3P4/1K4Q1/8/7k/8 w - - 97 104" ) );
-//         Search search( sp );
-
-//         for ( int i = 2; i < 7; i++ ) {
-//             search.negaMaxRoot( i );
-//             Move move = search.myBestMove;
-//             REQUIRE( move.toShortString() == "d7h7" );
-//         }
-//     }
-// }
\ No newline at end of file
+/* --------------------------------- search --------------------------------- */
+TEST_CASE( "Search stops at the node limit and finds mate in one", "[Search.search]" ) {
+    Search s;
+    Board b( "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1" );
+    PieceValidMoves g;
+    g.generateValidMoves( b );
+    std::atomic<bool> stop = false;
+
+    SearchLimits limits;
+    limits.depth = 4;
+    int iterations = 0;
+    auto bestMove = s.search( b, limits, stop, [&]( const SearchInfo &info ) { iterations += info.completed; } );
+    REQUIRE( bestMove.src == 56 );
+    REQUIRE( bestMove.dest == 0 );
+    REQUIRE( bestMove.score == POSITIVE_INFINITY );
+    REQUIRE( iterations == 2 );
+
+    b = Board();
+    g.generateValidMoves( b );
+    limits = SearchLimits();
+    limits.nodes = 5000;
+    bestMove = s.search( b, limits, stop );
+    REQUIRE( stop );
+    REQUIRE( bestMove.src != NULL_SQUARE );
+}
+
+TEST_CASE( "Search statistics are summed over the iterations and threads", "[Search.search]" ) {
+    Search s;
+    Board b( "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3" );
+    PieceValidMoves g;
+    g.generateValidMoves( b );
+    std::atomic<bool> stop = false;
+    SearchLimits limits;
+    limits.depth = 3;
+
+    SearchStats single;
+    uint64_t reportedNodes = 0;
+    s.search( b, limits, stop, [&]( const SearchInfo &info ) { reportedNodes = info.nodes; }, &single );
+    REQUIRE( single.nodes == reportedNodes );
+    REQUIRE( single.iterations.size() == 3 );
+    uint64_t iterationNodes = 0;
+    for ( const auto &iteration : single.iterations ) {
+        iterationNodes += iteration.nodes;
+    }
+    REQUIRE( iterationNodes == single.nodes );
+    REQUIRE( single.evaluations > 0 );
+    REQUIRE( single.cutoffs > 0 );
+    REQUIRE( single.firstMoveCutoffs <= single.cutoffs );
+    REQUIRE( single.effectiveBranchingFactor() > 1.0 );
+    REQUIRE( single.pawnHashProbes == single.evaluations );
+    REQUIRE( single.pawnHashHitRate() > 0.5 );
+    REQUIRE( single.pawnHashUsage > 0.0 );
+
+    // Windows of the root moves depend on which thread finishes first, so only the sums are compared
+    s.setThreads( 3 );
+    SearchStats parallel;
+    s.search( b, limits, stop, nullptr, &parallel );
+    iterationNodes = 0;
+    for ( const auto &iteration : parallel.iterations ) {
+        iterationNodes += iteration.nodes;
+    }
+    REQUIRE( parallel.iterations.size() == 3 );
+    REQUIRE( iterationNodes == parallel.nodes );
+    REQUIRE( parallel.pawnHashProbes == parallel.evaluations );
+    REQUIRE( parallel.pawnHashUsage > 0.0 );
+    REQUIRE( parallel.pawnHashUsage <= 1.0 );
+    REQUIRE( parallel.firstMoveCutoffs <= parallel.cutoffs );
+}
+
+TEST_CASE( "Helper threads are kept between the searches and restarted when their number changes",
+           "[Search.search]" ) {
+    Search s;
+    Board b( "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1" );
+    PieceValidMoves g;
+    g.generateValidMoves( b );
+    std::atomic<bool> stop = false;
+    SearchLimits limits;
+    limits.depth = 3;
+
+    for ( int threads : { 4, 4, 2, 1, 3 } ) {
+        s.setThreads( threads );
+        REQUIRE( s.getThreads() == threads );
+        SearchStats stats;
+        const auto bestMove = s.search( b, limits, stop, nullptr, &stats );
+        REQUIRE( bestMove.src == 56 );
+        REQUIRE( bestMove.dest == 0 );
+        REQUIRE( stats.iterations.size() == 2 );
+    }
+}
+
+TEST_CASE( "getBestMove returns the statistics of the search", "[Search.getBestMove]" ) {
+    Search s;
+    Board b( "8/8/4k3/8/8/3NK3/8/8 w - - 0 1" );
+    PieceValidMoves g;
+    g.generateValidMoves( b );
+    SearchStats stats;
+    s.getBestMove( b, 2, &stats );
+    REQUIRE( stats.iterations.size() == 2 );
+    REQUIRE( stats.nodes > 0 );
+    REQUIRE( stats.materialDraws == stats.nodes );
+    REQUIRE( stats.evaluations == 0 );
+}
+
+/* ------------------------------- startSearch ------------------------------ */
+TEST_CASE( "Engine searches asynchronously and reports the principal variation", "[Engine.startSearch]" ) {
+    Engine engine;
+    // Fool's mate, black to move mates with d8h4
+    engine.makeMove( 53, 45 );
+    engine.makeMove( 12, 28 );
+    engine.makeMove( 54, 38 );
+
+    SearchLimits limits;
+    limits.depth = 3;
+    std::vector<SearchInfo> infos;
+    auto handle = engine.startSearch( limits, [&]( const SearchInfo &info ) { infos.push_back( info ); } );
+    const MoveContent bestMove = handle.bestMove().get();
+    handle.wait();
+
+    REQUIRE( bestMove.src == 3 );
+    REQUIRE( bestMove.dest == 39 );
+    REQUIRE( handle.isFinished() );
+    REQUIRE( infos.back().completed );
+    REQUIRE( infos.back().score == NEGATIVE_INFINITY );
+    REQUIRE( infos.back().pv.size() == 1 );
+    REQUIRE( infos.back().pv.front().dest == 39 );
+}
+
+TEST_CASE( "Engine runs concurrent searches until they are stopped", "[Engine.startSearch]" ) {
+    Engine engine;
+    SearchLimits limits;
+    limits.infinite = true;
+
+    auto first = engine.startSearch( limits );
+    auto second = engine.startSearch( limits );
+    // Searches work on copies, so the game can go on
+    REQUIRE( engine.makeMove( 52, 36 ) );
+    REQUIRE_FALSE( first.isFinished() );
+
+    const auto start = std::chrono::steady_clock::now();
+    first.stop();
+    second.stop();
+    const MoveContent firstMove = first.bestMove().get();
+    const MoveContent secondMove = second.bestMove().get();
+    REQUIRE( std::chrono::steady_clock::now() - start < std::chrono::milliseconds( 500 ) );
+    REQUIRE( firstMove.src != NULL_SQUARE );
+    REQUIRE( secondMove.src != NULL_SQUARE );
+    REQUIRE( engine.board->squares[36]->type == PAWN );
+}
+
+TEST_CASE( "Engine ponders on the expected move until the ponder hit", "[Engine.startPondering]" ) {
+    Engine engine;
+    MoveContent expectedMove;
+    expectedMove.src = 52;
+    expectedMove.dest = 36;
+
+    SearchLimits limits;
+    limits.moveTime = 100;
+    auto handle = engine.startPondering( expectedMove, limits );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 300 ) );
+    REQUIRE_FALSE( handle.isFinished() );
+
+    handle.ponderHit();
+    const MoveContent bestMove = handle.bestMove().get();
+    REQUIRE( engine.board->squares[bestMove.src]->color == BLACK );
+
+    expectedMove.dest = 28;
+    REQUIRE_THROWS( engine.startPondering( expectedMove, limits ) );
+}
+
+/* -------------------------------- Multi-PV -------------------------------- */
+TEST_CASE( "Multi-PV search returns the best lines with exact scores", "[Search.searchLines]" ) {
+    Search s;
+    PieceValidMoves g;
+    Board b( "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3" );
+    g.generateValidMoves( b );
+    std::atomic<bool> stop = false;
+
+    // Exact score of every root move is the score of the position after it searched one ply less
+    std::vector<int> scores;
+    SearchLimits childLimits;
+    childLimits.depth = 1;
+    for ( const auto &move : s.getPossibleMoves( b ) ) {
+        Board child = b;
+        child.makeMove( move.src, move.dest, move.promotion );
+        g.generateValidMoves( child );
+        if ( g.validateBoard( child ) ) {
+            scores.push_back( s.search( child, childLimits, stop ).score );
+        }
+    }
+    std::sort( scores.rbegin(), scores.rend() );
+
+    SearchLimits limits;
+    limits.depth = 2;
+    limits.multiPv = 3;
+    for ( int threads : { 1, 3 } ) {
+        s.setThreads( threads );
+        const auto lines = s.searchLines( b, limits, stop );
+        REQUIRE( lines.size() == 3 );
+        for ( std::size_t i = 0; i < lines.size(); i++ ) {
+            REQUIRE( lines[i].score == scores[i] );
+            REQUIRE( lines[i].pv.size() == 2 );
+        }
+        const auto &first = lines[0].pv.front();
+        const auto &second = lines[1].pv.front();
+        REQUIRE_FALSE( ( first.src == second.src && first.dest == second.dest ) );
+    }
+}
@@ -0,0 +1,93 @@
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "Search.h"
+#include "Trace.h"
+#include "catch2/catch_test_macros.hpp"
+
+static std::size_t countOf( const std::string &text, const std::string &pattern ) {
+    std::size_t count = 0;
+    for ( auto position = text.find( pattern ); position != std::string::npos;
+          position = text.find( pattern, position + 1 ) ) {
+        count++;
+    }
+    return count;
+}
+
+TEST_CASE( "Trace records the scopes of every thread", "[Trace]" ) {
+    Trace::clear();
+    {
+        const TraceScope outer( "outer" );
+        const TraceScope inner( "inner" );
+    }
+    std::thread( [] { const TraceScope scope( "worker" ); } ).join();
+
+    std::ostringstream out;
+    Trace::write( out );
+    const std::string json = out.str();
+    REQUIRE( json.find( "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" ) == 0 );
+    REQUIRE( countOf( json, "\"ph\":\"X\"" ) == 3 );
+    REQUIRE( countOf( json, "\"name\":\"outer\"" ) == 1 );
+    REQUIRE( countOf( json, "\"name\":\"worker\"" ) == 1 );
+    REQUIRE( Trace::threadBuffer().threadId() != 0 );
+
+    // Inner scope ends first and lies within the outer one
+    const auto events = Trace::threadBuffer().events();
+    REQUIRE( events.size() == 2 );
+    REQUIRE( std::string( events[0].name ) == "inner" );
+    REQUIRE( events[1].start <= events[0].start );
+    REQUIRE( events[1].start + events[1].duration >= events[0].start + events[0].duration );
+
+    Trace::clear();
+    std::ostringstream empty;
+    Trace::write( empty );
+    REQUIRE( countOf( empty.str(), "\"ph\"" ) == 0 );
+}
+
+TEST_CASE( "Search threads keep their buffers over the iterations", "[Trace]" ) {
+    Search search;
+    search.setThreads( 3 );
+    Board board;
+    PieceValidMoves generator;
+    generator.generateValidMoves( board );
+    std::atomic<bool> stop = false;
+    SearchLimits limits;
+    limits.depth = 3;
+
+    Trace::clear();
+    search.search( board, limits, stop );
+    std::ostringstream out;
+    Trace::write( out );
+    const std::string json = out.str();
+
+    // Every thread is a single timeline row, helpers are not started again for every iteration
+    std::set<std::string> threadIds;
+    for ( auto position = json.find( "\"tid\":" ); position != std::string::npos;
+          position = json.find( "\"tid\":", position + 1 ) ) {
+        threadIds.insert( json.substr( position, json.find( ',', position ) - position ) );
+    }
+    REQUIRE( countOf( json, "\"name\":\"Search::iteration\"" ) == ( Trace::isEnabled() ? 3 : 0 ) );
+    REQUIRE( threadIds.size() <= 3 );
+    Trace::clear();
+}
+
+TEST_CASE( "Trace buffer keeps the latest events", "[Trace]" ) {
+    TraceBuffer buffer( 1 );
+    for ( uint64_t i = 0; i < TRACE_BUFFER_SIZE + 10; i++ ) {
+        buffer.record( { "event", i, 1 } );
+    }
+    const auto events = buffer.events();
+    REQUIRE( events.size() == TRACE_BUFFER_SIZE );
+    REQUIRE( events.front().start == 10 );
+    REQUIRE( events.back().start == TRACE_BUFFER_SIZE + 9 );
+}
+
+TEST_CASE( "Trace macros compile to nothing unless enabled", "[Trace]" ) {
+    Trace::clear();
+    {
+        TRACE_SCOPE( "macro" );
+    }
+    REQUIRE( Trace::threadBuffer().events().size() == ( Trace::isEnabled() ? 1 : 0 ) );
+    Trace::clear();
+}
@@ -0,0 +1,92 @@
+#include <cmath>
+#include <filesystem>
+#include <sstream>
+
+#include "Evaluation.h"
+#include "Tuner.h"
+#include "catch2/catch_test_macros.hpp"
+
+static const char *FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w Kq - 3 17",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r1bq1rk1/pp3ppp/2n1pn2/2pp4/1bPP4/2NBPN2/PP3PPP/R1BQ1RK1 w - - 0 8",
+    "6k1/5ppp/8/3P4/8/8/1B3PPP/6K1 w - - 0 40",
+    "2r3k1/1p3pp1/p3p2p/3pP3/1P1P4/P4N1P/5PP1/2R3K1 b - - 1 30",
+};
+
+/* ------------------------------- Positions -------------------------------- */
+
+TEST_CASE( "Linear evaluation matches the evaluation of the board", "[Tuner]" ) {
+    Tuner tuner;
+    for ( auto fen : FENS ) {
+        REQUIRE( tuner.addPosition( Board( fen ), 0.5 ) );
+        // Evaluation rounds the interpolated score down
+        const int score = Evaluation::evaluateBoard( Board( fen ) );
+        REQUIRE( std::abs( tuner.evaluate( tuner.size() - 1 ) - score ) < 1.0 );
+    }
+}
+
+TEST_CASE( "Specialized endgames are skipped", "[Tuner]" ) {
+    Tuner tuner;
+    REQUIRE_FALSE( tuner.addPosition( Board( "8/8/4k3/8/8/3NK3/8/8 w - - 0 1" ), 0.5 ) );
+    REQUIRE_FALSE( tuner.addPosition( Board( "8/8/4k3/8/8/4K3/8/4Q3 w - - 0 1" ), 1.0 ) );
+    REQUIRE( tuner.size() == 0 );
+    REQUIRE( tuner.loss( 1.0 ) == 0.0 );
+}
+
+TEST_CASE( "End game parameters follow the middle game ones", "[Tuner]" ) {
+    REQUIRE( Tuner::endGameIndex( Tuner::PIECE_VALUES_INDEX + PAWN ) == Tuner::PIECE_VALUES_INDEX + PAWN );
+    REQUIRE( Tuner::endGameIndex( Tuner::PIECE_SQUARE_INDEX + 10 ) == Tuner::PIECE_SQUARE_INDEX + 7 * 64 + 10 );
+    REQUIRE( Tuner::endGameIndex( Tuner::DOUBLED_PAWN_INDEX ) == Tuner::DOUBLED_PAWN_INDEX + 1 );
+    REQUIRE( Tuner::endGameIndex( Tuner::PAWN_SHIELD_INDEX ) == Tuner::PAWN_SHIELD_INDEX + 1 );
+    REQUIRE( Tuner::endGameIndex( Tuner::PASSED_PAWN_INDEX + 3 ) == Tuner::PASSED_PAWN_INDEX + 11 );
+    REQUIRE( Tuner::endGameIndex( Tuner::BISHOP_PAIR_INDEX ) == Tuner::BISHOP_PAIR_INDEX );
+}
+
+/* --------------------------------- Tuning --------------------------------- */
+
+TEST_CASE( "Tuning reduces the loss on all threads", "[Tuner]" ) {
+    Tuner single( 1 ), parallel( 4 );
+    for ( int i = 0; i < 6; i++ ) {
+        // White wins the even positions whatever the evaluation says
+        single.addPosition( Board( FENS[i] ), i % 2 == 0 ? 1.0 : 0.0 );
+        parallel.addPosition( Board( FENS[i] ), i % 2 == 0 ? 1.0 : 0.0 );
+    }
+    REQUIRE( std::abs( single.loss( 1.0 ) - parallel.loss( 1.0 ) ) < 1e-12 );
+
+    const double scale = parallel.findScale();
+    REQUIRE( scale > 0.0 );
+    const double before = parallel.loss( scale );
+    int iterations = 0;
+    parallel.tune( 50, scale, 1.0, [&]( int, double ) { iterations++; } );
+    REQUIRE( iterations == 50 );
+    REQUIRE( parallel.loss( scale ) < before );
+}
+
+TEST_CASE( "Tuner reads positions with results from the file", "[Tuner]" ) {
+    const std::string path = ( std::filesystem::temp_directory_path() / "tuner_test.bin" ).string();
+    {
+        PositionWriter writer( path );
+        writer.write( Board( FENS[1] ), 0, 1 );
+        writer.write( Board( FENS[3] ) );
+        writer.write( Board( FENS[5] ), 0, -1 );
+    }
+    Tuner tuner;
+    tuner.addPositions( PositionFile( path ) );
+    REQUIRE( tuner.size() == 2 );
+    std::filesystem::remove( path );
+}
+
+/* --------------------------------- Output --------------------------------- */
+
+TEST_CASE( "Written parameters regenerate the evaluation header", "[Tuner]" ) {
+    std::ostringstream out;
+    Tuner().writeParameters( out );
+    const std::string header = out.str();
+    REQUIRE( header.find( "#define EVALUATION_PARAMETERS_H" ) != std::string::npos );
+    REQUIRE( header.find( "auto const KNIGHT_VALUE = 300;" ) != std::string::npos );
+    REQUIRE( header.find( "const int DOUBLED_PAWN_PENALTY[2] = { 10, 20 };" ) != std::string::npos );
+    REQUIRE( header.find( "const int8_t QUEEN_END_GAME_TABLE[64] = {" ) != std::string::npos );
+    REQUIRE( header.find( "const int8_t* const PIECE_SQUARE_TABLES[2][7] = {" ) != std::string::npos );
+}
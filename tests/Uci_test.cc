@@ -0,0 +1,144 @@
+#include <chrono>
+#include <sstream>
+
+#include "Uci.h"
+#include "catch2/catch_test_macros.hpp"
+
+static bool contains( const std::ostringstream &out, const std::string &text ) {
+    return out.str().find( text ) != std::string::npos;
+}
+
+/* -------------------------------- Handshake ------------------------------- */
+
+TEST_CASE( "Uci identifies the engine and its options", "[Uci.execute]" ) {
+    std::istringstream in;
+    std::ostringstream out;
+    Uci uci( in, out );
+
+    REQUIRE( uci.execute( "uci" ) );
+    REQUIRE( contains( out, "id name" ) );
+    REQUIRE( contains( out, "option name Hash type spin" ) );
+    REQUIRE( contains( out, "option name Threads type spin" ) );
+    REQUIRE( contains( out, "uciok" ) );
+
+    REQUIRE( uci.execute( "isready" ) );
+    REQUIRE( contains( out, "readyok" ) );
+    REQUIRE_FALSE( uci.execute( "quit" ) );
+}
+
+/* --------------------------------- Search --------------------------------- */
+
+TEST_CASE( "Uci searches the position to the given depth", "[Uci.go]" ) {
+    std::istringstream in;
+    std::ostringstream out;
+    Uci uci( in, out );
+
+    uci.execute( "position fen 6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1" );
+    uci.execute( "go depth 3" );
+    uci.waitForSearch();
+    REQUIRE( contains( out, "info depth 2 score mate 1" ) );
+    REQUIRE( contains( out, "bestmove a1a8" ) );
+}
+
+TEST_CASE( "Uci sends search statistics in debug mode", "[Uci.go]" ) {
+    std::istringstream in;
+    std::ostringstream out;
+    Uci uci( in, out );
+
+    uci.execute( "go depth 2" );
+    uci.waitForSearch();
+    REQUIRE_FALSE( contains( out, "info string nodes" ) );
+
+    uci.execute( "debug on" );
+    uci.execute( "go depth 2" );
+    uci.waitForSearch();
+    REQUIRE( contains( out, "info string nodes" ) );
+    REQUIRE( contains( out, "ebf" ) );
+}
+
+TEST_CASE( "Uci applies moves to the position", "[Uci.position]" ) {
+    std::istringstream in;
+    std::ostringstream out;
+    Uci uci( in, out );
+
+    // Fool's mate, black to move mates with d8h4
+    uci.execute( "position startpos moves f2f3 e7e5 g2g4" );
+    uci.execute( "go depth 2" );
+    uci.waitForSearch();
+    REQUIRE( contains( out, "bestmove d8h4" ) );
+
+    uci.execute( "position startpos moves e2e5" );
+    REQUIRE( contains( out, "info string" ) );
+}
+
+TEST_CASE( "Uci answers isready and stop during infinite search", "[Uci.stop]" ) {
+    std::istringstream in;
+    std::ostringstream out;
+    Uci uci( in, out );
+
+    uci.execute( "setoption name Threads value 2" );
+    uci.execute( "position startpos" );
+    uci.execute( "go infinite" );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+    const auto start = std::chrono::steady_clock::now();
+    // Threads of the running search are not touched, the option applies to the next search
+    uci.execute( "setoption name Threads value 3" );
+    uci.execute( "isready" );
+    uci.execute( "stop" );
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE( elapsed < std::chrono::milliseconds( 200 ) );
+    REQUIRE( contains( out, "readyok" ) );
+    REQUIRE( contains( out, "bestmove" ) );
+}
+
+TEST_CASE( "Uci search respects the movetime", "[Uci.go]" ) {
+    std::istringstream in;
+    std::ostringstream out;
+    Uci uci( in, out );
+
+    const auto start = std::chrono::steady_clock::now();
+    uci.execute( "go movetime 300" );
+    uci.waitForSearch();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE( elapsed < std::chrono::milliseconds( 600 ) );
+    REQUIRE( contains( out, "bestmove" ) );
+}
+
+TEST_CASE( "Uci ponders until ponderhit and suggests the move to ponder on", "[Uci.ponder]" ) {
+    std::istringstream in;
+    std::ostringstream out;
+    Uci uci( in, out );
+
+    uci.execute( "position startpos moves e2e4" );
+    uci.execute( "go ponder movetime 100" );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 300 ) );
+    REQUIRE_FALSE( contains( out, "bestmove" ) );
+
+    // Time of the search is already used, so it stops right after the ponder hit
+    const auto start = std::chrono::steady_clock::now();
+    uci.execute( "ponderhit" );
+    uci.waitForSearch();
+    REQUIRE( std::chrono::steady_clock::now() - start < std::chrono::milliseconds( 200 ) );
+    REQUIRE( contains( out, "bestmove" ) );
+
+    uci.execute( "position startpos" );
+    uci.execute( "go depth 3" );
+    uci.waitForSearch();
+    REQUIRE( contains( out, " ponder " ) );
+}
+
+TEST_CASE( "Uci reports every line of the multi-PV search", "[Uci.go]" ) {
+    std::istringstream in;
+    std::ostringstream out;
+    Uci uci( in, out );
+
+    uci.execute( "setoption name MultiPV value 3" );
+    uci.execute( "go depth 2" );
+    uci.waitForSearch();
+    REQUIRE( contains( out, "info depth 2 multipv 1 score cp" ) );
+    REQUIRE( contains( out, "info depth 2 multipv 3 score cp" ) );
+    REQUIRE_FALSE( contains( out, "multipv 4" ) );
+}